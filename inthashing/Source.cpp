@@ -10,17 +10,45 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <unordered_set>
+#include <fstream>
 
-#include <boost/random/xoroshiro.hpp>
 #include <boost/random/seed_seq_fe.hpp>
 #include <boost/random/random_device.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
 #include <boost/random/bernoulli_distribution.hpp>
+#include <boost/align/aligned_allocator.hpp>
 
 #include <integer_utils.hpp>
 
 #include <autotimer.hpp>
 
+#include "inthashing.hpp"
+#include "popcount_histogram.hpp"
+#include "prefilter.hpp"
+#include "avalanche_matrix.hpp"
+#include "bijection.hpp"
+#include "bic_matrix.hpp"
+#include "checkpoint.hpp"
+#include "differentials.hpp"
+#include "exhaustive_kernel.hpp"
+#include "hash_battery.hpp"
+#include "key_streams.hpp"
+#include "mixer_composition.hpp"
+#include "sac_kernel.hpp"
+#include "score_db.hpp"
+#include "telemetry.hpp"
+#include "worker_pool.hpp"
+
 /*
 https://crypto.stackexchange.com/questions/34269/calculation-of-the-avalanche-effect-coefficient#35172
 
@@ -42,41 +70,113 @@ Standard deviation should be 0.5 * sqrt ( N = 512 ) = 11.3137...
 
 */
 
-namespace inthashing {
+template < typename N >
+N set_mask_0 ( const std::uint32_t bit_ ) noexcept {
 
-	template<typename T>
-	T hash ( T x_, const T m_ ) {
+	return N ( 1 ) << bit_;
+}
+
+
+// boost::random::seed_seq_fe256 g_seq { 36534427, 234237, 144433, 2144421 };
+
+// Every thread draws from its own stream, handed out on first use. The
+// streams are split off a master generator with jump ( ), i.e. they are
+// 2^64 draws apart and never overlap...
+
+jimi::XoRoShiRo128Plus g_rng_master ( iu::seed<std::uint64_t> ( ) );
+std::mutex g_rng_master_mutex;
+
+jimi::XoRoShiRo128Plus nextStream ( ) {
+
+	std::lock_guard<std::mutex> lock ( g_rng_master_mutex );
+
+	const jimi::XoRoShiRo128Plus stream = g_rng_master;
+
+	g_rng_master.jump ( );
 
-		x_ = ( ( x_ >> ( ( sizeof ( T ) / 2 ) * 8 ) ) ^ x_ ) * m_;
-		x_ = ( ( x_ >> ( ( sizeof ( T ) / 2 ) * 8 ) ) ^ x_ ) * m_;
-		//x_ = ( ( x_ >> ( ( sizeof ( T ) / 2 ) * 8 ) ) ^ x_ ) * m_;
+	return stream;
+}
+
+thread_local jimi::XoRoShiRo128Plus g_rng ( nextStream ( ) );
+
+
+// At 128 bits from two draws, boost's distributions go by the type traits,
+// which don't know the type...
+
+template<typename T>
+T getRandom ( ) noexcept {
+
+	if constexpr ( sizeof ( T ) > sizeof ( std::uint64_t ) ) {
 
-		return ( x_ >> ( ( sizeof ( T ) / 2 ) * 8 ) ) ^ x_;
+		const T high = T ( g_rng ( ) );
+
+		return T ( ( high << 64 ) | T ( g_rng ( ) ) );
 	}
 
-	template<typename T>
-	T mul_m ( T x_, const T m_ ) {
+	else {
 
-		return x_ * m_;
+		return boost::random::uniform_int_distribution<T> ( ) ( g_rng );
 	}
-};
+}
 
+template<typename T>
+std::uint32_t popCount ( const T x_ ) noexcept {
 
-template < typename N >
-N set_mask_0 ( const std::uint32_t bit_ ) noexcept {
+	if constexpr ( sizeof ( T ) > sizeof ( std::uint64_t ) ) {
 
-	return N ( 1 ) << bit_;
+		return jimi::popCount ( x_ );
+	}
+
+	else {
+
+		return iu::popCount ( x_ );
+	}
 }
 
+// "0x" and 16 hex digits, 32 at 128 bits...
 
-// boost::random::seed_seq_fe256 g_seq { 36534427, 234237, 144433, 2144421 };
-boost::random::xoroshiro128plus g_rng ( iu::seed<typename boost::random::xoroshiro128plus::result_type> ( ) );
+template<typename T>
+std::string hexString ( const T x_ ) {
+
+	char s [ 40 ];
+
+	if constexpr ( sizeof ( T ) > sizeof ( std::uint64_t ) ) {
 
+		snprintf ( s, sizeof ( s ), "0x%016llX%016llX", ( unsigned long long ) ( x_ >> 64 ), ( unsigned long long ) x_ );
+	}
+
+	else {
+
+		snprintf ( s, sizeof ( s ), "0x%016llX", ( unsigned long long ) x_ );
+	}
+
+	return s;
+}
+
+// As C++ source, a literal, at 128 bits put together from its halves...
 
 template<typename T>
-T getRandom ( ) noexcept {
+std::string literalString ( const T x_ ) {
 
-	return boost::random::uniform_int_distribution<T> ( ) ( g_rng );
+	char s [ 64 ];
+
+	if constexpr ( sizeof ( T ) > sizeof ( std::uint64_t ) ) {
+
+		snprintf ( s, sizeof ( s ), "( jimi::uint128_t ( 0x%llX ) << 64 | 0x%llX )", ( unsigned long long ) ( x_ >> 64 ), ( unsigned long long ) x_ );
+	}
+
+	else {
+
+		snprintf ( s, sizeof ( s ), "0x%llX", ( unsigned long long ) x_ );
+	}
+
+	return s;
+}
+
+template<typename T>
+std::string typeName ( ) {
+
+	return sizeof ( T ) > sizeof ( std::uint64_t ) ? "jimi::uint128_t" : "std::uint" + std::to_string ( sizeof ( T ) * 8 ) + "_t";
 }
 
 
@@ -94,6 +194,27 @@ T flipRandomBit ( const T i_ ) noexcept {
 	return flipBit ( i_, uid ( g_rng ) );
 }
 
+// Batch version of flipRandomBit, takes the bit indices from a single draw
+// while there are bits left in it...
+
+template<typename T>
+void flipRandomBits ( const T * x_, T * y_, const std::size_t n_ ) noexcept {
+
+	constexpr std::uint32_t bits = jimi::iLog2<std::uint32_t> ( sizeof ( T ) * 8 ), per_draw = 64 / bits;
+
+	std::uint64_t r = 0;
+
+	for ( std::size_t i = 0; i < n_; ++i, r >>= bits ) {
+
+		if ( not ( i % per_draw ) ) {
+
+			r = g_rng ( );
+		}
+
+		y_ [ i ] = flipBit ( x_ [ i ], std::uint32_t ( r & ( sizeof ( T ) * 8 - 1 ) ) );
+	}
+}
+
 
 // strict avalanche criterion
 // https://en.wikipedia.org/wiki/Avalanche_effect
@@ -101,7 +222,7 @@ T flipRandomBit ( const T i_ ) noexcept {
 template<typename T>
 double getKsac ( const T x_, const T y_, const T m_ ) noexcept {
 
-	return ( double ) iu::popCount ( iu::bit_xor ( inthashing::hash ( x_, m_ ), inthashing::hash ( y_, m_ ) ) ) / double ( sizeof ( T ) * 8 );
+	return ( double ) popCount ( iu::bit_xor ( inthashing::hash ( x_, m_ ), inthashing::hash ( y_, m_ ) ) ) / double ( sizeof ( T ) * 8 );
 }
 
 template<typename T>
@@ -112,78 +233,231 @@ double getRandomKsac ( const T m_ ) noexcept {
 	return getKsac ( x, flipRandomBit ( x ), m_ );
 }
 
+// Consecutive values from a per thread counter, starting at a random offset...
+
+template<typename T>
+T getLowEntropy ( ) noexcept {
+
+	thread_local T x = getRandom<T> ( );
+
+	return ++x;
+}
+
 template<typename T>
 double getLowEntropyKsac ( const T m_ ) noexcept {
 
-	static T x = getRandom<T> ( );
-
-	++x;
+	const T x = getLowEntropy<T> ( );
 
 	return getKsac ( x, flipRandomBit ( x ), m_ );
 }
 
 
+// The popcounts of the output differences of all single bit flips of x_...
+
+template<typename T>
+void addFsacHistogram ( const T x_, const T m_, popcount_histogram<T> & histogram_ ) noexcept {
+
+	const T h = inthashing::hash ( x_, m_ );
+
+	for ( std::uint32_t i = 0; i < sizeof ( T ) * 8; ++i ) {
+
+		histogram_.add ( popCount ( T ( h ^ inthashing::hash ( flipBit ( x_, i ), m_ ) ) ) );
+	}
+}
+
 template<typename T>
 double getFsacError ( const T x_, const T m_ ) noexcept {
 
-	double error = getKsac ( x_, flipBit ( x_, 0 ), m_ ) - 0.5, mean_squared_error = error * error;
+	popcount_histogram<T> histogram;
+
+	addFsacHistogram ( x_, m_, histogram );
+
+	return histogram.msr ( );
+}
+
+// Exhaustive scoring. The error is kept as an exact integer, the sum over
+// the inputs and bits of ( popcount ( d ) - w / 2 )^2. All terms are non-
+// negative, so a partial sum over part of the domain is a lower bound of
+// the total and scoring a multiplier stops as soon as it exceeds the bound...
+
+template<typename T>
+std::uint64_t getFsacSquaredDeviation ( const std::uint64_t b_, const std::uint64_t e_, const T m_ ) noexcept {
+
+	constexpr std::int64_t half = sizeof ( T ) * 4;
+
+	std::uint64_t sum = 0;
+
+	for ( std::uint64_t x = b_; x < e_; ++x ) {
+
+		const T h = inthashing::hash ( ( T ) x, m_ );
 
-	for ( std::uint32_t i = 1; i < sizeof ( T ) * 8; ++i ) {
+		for ( std::uint32_t i = 0; i < sizeof ( T ) * 8; ++i ) {
 
-		error = getKsac ( x_, flipBit ( x_, i ), m_ ) - 0.5;
+			const std::int64_t d = std::int64_t ( popCount ( T ( h ^ inthashing::hash ( flipBit ( ( T ) x, i ), m_ ) ) ) ) - half;
 
-		mean_squared_error += ( error * error - mean_squared_error ) / i;
+			sum += std::uint64_t ( d * d );
+		}
 	}
 
-	return mean_squared_error;
+	return sum;
+}
+
+template<typename T>
+constexpr double getTotalFsacNorm ( ) noexcept {
+
+	return double ( sizeof ( T ) * 8 ) * double ( sizeof ( T ) * 8 ) * double ( sizeof ( T ) * 8 ) * ( double ( std::numeric_limits<T>::max ( ) ) + 1.0 );
+}
+
+constexpr std::uint64_t fsac_chunk_size = 4 * 1'024;
+
+// Single threaded, over the whole domain, gives up (returning a value
+// > bound_) as soon as the partial sum exceeds bound_. 8 or 16 bits, from
+// a table of the hashes of the whole domain, see exhaustive_kernel.hpp...
+
+template<typename T>
+std::uint64_t getTotalFsacSquaredDeviation ( const T m_, const std::uint64_t bound_ ) noexcept {
+
+	alignas ( 64 ) thread_local T h [ inthashing::domain<T>::size ];
+
+	inthashing::hashDomain ( m_, h );
+
+	return inthashing::domainSquaredDeviation ( h, bound_ );
+}
+
+// The scalar sum, with the domain sharded over the worker pool, for scoring
+// a single (32-bit) multiplier...
+
+template<typename T>
+std::uint64_t getTotalFsacSquaredDeviationParallel ( const T m_, const std::uint64_t bound_ = std::numeric_limits<std::uint64_t>::max ( ) ) {
+
+	constexpr std::uint64_t domain = std::uint64_t ( std::numeric_limits<T>::max ( ) ) + 1;
+
+	std::atomic<std::uint64_t> next ( 0 ), sum ( 0 );
+
+	workers ( ).run ( [ & ] ( std::size_t ) {
+
+		for ( std::uint64_t b = next.fetch_add ( fsac_chunk_size ); b < domain and sum.load ( std::memory_order_relaxed ) <= bound_; b = next.fetch_add ( fsac_chunk_size ) ) {
+
+			sum.fetch_add ( getFsacSquaredDeviation ( b, std::min ( b + fsac_chunk_size, domain ), m_ ), std::memory_order_relaxed );
+		}
+	} );
+
+	return sum.load ( );
 }
 
+// The best of the multipliers_, exhaustively scored one at a time, each
+// sharded over the worker pool, the best so far is the bound for the next...
+
 template<typename T>
-double getTotalFsacError ( const T m_ ) noexcept {
+T getBestM ( const std::vector<T> & multipliers_ ) {
+
+	T best_m = multipliers_.front ( );
+	std::uint64_t best_sum = getTotalFsacSquaredDeviationParallel ( best_m );
+
+	std::cout << "m " << ( std::uint64_t ) best_m << " best error " << double ( best_sum ) / getTotalFsacNorm<T> ( ) << '\n';
+
+	for ( std::size_t i = 1; i < multipliers_.size ( ); ++i ) {
 
-	double mean_error = getFsacError ( ( T ) 0, m_ );
+		const std::uint64_t sum = getTotalFsacSquaredDeviationParallel ( multipliers_ [ i ], best_sum );
 
-	for ( std::uint32_t i = 1; i < std::numeric_limits<T>::max ( ); ++i ) {
+		if ( sum < best_sum or ( sum == best_sum and multipliers_ [ i ] < best_m ) ) {
 
-		mean_error += ( getFsacError ( ( T ) i, m_ ) - mean_error ) / i;
+			best_m = multipliers_ [ i ];
+			best_sum = sum;
+
+			std::cout << "m " << ( std::uint64_t ) best_m << " best error " << double ( best_sum ) / getTotalFsacNorm<T> ( ) << '\n';
+		}
 	}
 
-	return mean_error;
+	return best_m;
 }
 
+// All odd multipliers (8- and 16-bit), one multiplier per worker, scored
+// single threaded against the shared best. Each worker keeps its table of
+// the domain (128 KB at 16 bits) in its own cache...
+
 template<typename T>
-T getBestM ( ) noexcept {
+T getBestM ( ) {
 
+	constexpr std::uint64_t domain = std::uint64_t ( std::numeric_limits<T>::max ( ) ) + 1;
+
+	std::mutex best_mutex;
 	T best_m = 3;
-	double best_error = getTotalFsacError ( best_m );
+	std::atomic<std::uint64_t> best_sum ( getTotalFsacSquaredDeviation ( best_m, std::numeric_limits<std::uint64_t>::max ( ) ) );
 
-	//std::cout << "i " << ( std::uint32_t ) 0 << " " << " error " << best_error << '\n';
+	workers ( ).parallel_for ( ( domain - 4 ) / 2, [ & ] ( const std::size_t i ) {
 
-	for ( std::uint32_t i = 5; i <std::numeric_limits<T>::max ( ); i += 2 ) {
+		const T m = T ( 5 + 2 * i );
+		const std::uint64_t sum = getTotalFsacSquaredDeviation ( m, best_sum.load ( std::memory_order_relaxed ) );
 
-		const double error = getTotalFsacError ( ( T ) i );
+		if ( sum <= best_sum.load ( std::memory_order_relaxed ) ) {
 
-		if ( error < best_error ) {
+			std::lock_guard<std::mutex> lock ( best_mutex );
 
-			best_m = ( T ) i;
-			best_error = error;
+			if ( sum < best_sum.load ( ) or ( sum == best_sum.load ( ) and m < best_m ) ) {
 
-			///std::cout << "i " << ( std::uint32_t ) i << " " << " best error " << best_error << '\n';
+				best_m = m;
+				best_sum.store ( sum );
 
-			continue;
+				std::cout << "m " << ( std::uint64_t ) best_m << " best error " << double ( sum ) / getTotalFsacNorm<T> ( ) << '\n';
+			}
 		}
-
-		std::cout << "i " << ( std::uint32_t ) i << " " << " error " << error << " best m " << best_m << " best error " << best_error << '\n';
-	}
+	}, 1 );
 
 	return best_m;
 }
 
-int main3345678 ( ) {
+// Standalone: the best multiplier, exhaustively, over all inputs. Of all of
+// them at 8 or 16 bits, of a shortlist_ up to 32 bits (each one 2^32 inputs
+// times 33 hashes at 32 bits, sharded over the worker pool)...
+
+template<typename T>
+int mainExhaustive ( const std::vector<std::uint64_t> & shortlist_ ) {
 
-	std::cout << getBestM<std::uint16_t> ( ) << '\n';
+	if constexpr ( sizeof ( T ) > 4 ) {
 
-	return 0;
+		std::cerr << "exhaustive: up to 32 bits" << std::endl;
+
+		return 1;
+	}
+
+	else {
+
+		if ( shortlist_.empty ( ) ) {
+
+			if constexpr ( sizeof ( T ) > 2 ) {
+
+				std::cerr << "exhaustive: above 16 bits, only a shortlist (--multiplier, --shortlist)" << std::endl;
+
+				return 1;
+			}
+
+			else {
+
+				std::cout << ( std::uint64_t ) getBestM<T> ( ) << '\n';
+
+				return 0;
+			}
+		}
+
+		std::vector<T> multipliers;
+
+		for ( const std::uint64_t m : shortlist_ ) {
+
+			if ( not ( m & 1 ) or m > std::uint64_t ( std::numeric_limits<T>::max ( ) ) ) {
+
+				std::cerr << "exhaustive: " << m << " is not an odd " << sizeof ( T ) * 8 << "-bit multiplier" << std::endl;
+
+				return 1;
+			}
+
+			multipliers.push_back ( T ( m ) );
+		}
+
+		std::cout << ( std::uint64_t ) getBestM ( multipliers ) << '\n';
+
+		return 0;
+	}
 }
 
 template<typename T>
@@ -195,204 +469,2559 @@ double getRandomFsacError ( const T m_ ) noexcept {
 template<typename T>
 double getLowEntropyFsacError ( const T m_ ) noexcept {
 
-	static T x = getRandom<T> ( );
-
-	return getFsacError ( x++, m_ );
+	return getFsacError ( getLowEntropy<T> ( ), m_ );
 }
 
 template<typename T>
 double getCombinedFsacError ( const T m_, const size_t i_ ) noexcept {
 
-	double mean_error = 0.0, error;
-
-	std::size_t i = 1, last = i_ + 1;
+	popcount_histogram<T> histogram;
 
-	for ( ; i < last; ++i ) {
+	for ( std::size_t i = 0; i < i_; ++i ) {
 
-		error = getRandomFsacError ( m_ );
-
-		mean_error += ( error - mean_error ) / i;
+		addFsacHistogram ( getRandom<T> ( ), m_, histogram );
 	}
 
-	last = i_ * 2 + 1;
+	for ( std::size_t i = 0; i < i_; ++i ) {
 
-	for ( ; i < last; ++i ) {
+		addFsacHistogram ( getLowEntropy<T> ( ), m_, histogram );
+	}
 
-		error = getLowEntropyFsacError ( m_ );
+	return histogram.msr ( );
+}
 
-		mean_error += ( error - mean_error ) / i;
-	}
+template<typename T>
+std::uint32_t getKsacPopCount ( const T x_, const T m_ ) noexcept {
 
-	return mean_error;
+	return popCount ( T ( inthashing::hash ( x_, m_ ) ^ inthashing::hash ( flipRandomBit ( x_ ), m_ ) ) );
 }
 
 template<typename T>
 double getCombinedKsacMSR ( const T m_, const size_t i_ ) noexcept {
 
-	double mean_squared_error = 0.0, error;
+	popcount_histogram<T> histogram;
 
-	size_t i = 1, last = i_ + 1;
+	for ( std::size_t i = 0; i < i_; ++i ) {
 
-	for ( ; i < last; ++i ) {
+		histogram.add ( getKsacPopCount ( getRandom<T> ( ), m_ ) );
+	}
 
-		error = getRandomKsac<T> ( m_ ) - 0.5;
+	for ( std::size_t i = 0; i < i_; ++i ) {
 
-		mean_squared_error += ( error * error - mean_squared_error ) / i;
+		histogram.add ( getKsacPopCount ( getLowEntropy<T> ( ), m_ ) );
 	}
 
-	last = i_ * 2 + 1;
+	return histogram.msr ( );
+}
 
-	for ( ; i < last; ++i ) {
+// The input models the scorers draw from, each distribution in the mix
+// gets the same share of the samples. The default, uniform and counter, is
+// what the search always used (random and low entropy inputs). A replay
+// distribution reads the keys from g_key_replay_path...
 
-		error = getLowEntropyKsac<T> ( m_ ) - 0.5;
+std::vector<key_distribution> g_key_mix { key_distribution::uniform, key_distribution::counter };
+std::string g_key_replay_path;
 
-		mean_squared_error += ( error * error - mean_squared_error ) / i;
-	}
+template<typename T>
+const key_replay<T> * getKeyReplay ( ) {
+
+	static const std::unique_ptr<key_replay<T>> replay = [ ] ( ) -> std::unique_ptr<key_replay<T>> {
+
+		if ( g_key_replay_path.empty ( ) ) {
+
+			return nullptr;
+		}
+
+		try {
 
-	return mean_squared_error;
+			return std::make_unique<key_replay<T>> ( g_key_replay_path );
+		}
+
+		catch ( const boost::interprocess::interprocess_exception & e ) {
+
+			std::cerr << "replay: can not map " << g_key_replay_path << ", " << e.what ( ) << std::endl;
+
+			return nullptr;
+		}
+	} ( );
+
+	return replay.get ( );
 }
 
+// n_ keys from distribution d_, in buffer_ or straight from the replay file...
 
 template<typename T>
-bool isInverse ( const T m1_, const T m2_ ) noexcept {
+const T * getKeys ( const key_distribution d_, T * buffer_, const std::size_t n_ ) {
 
-	for ( uint32_t i = 0; i < 1'000'000'000; ++i ) {
+	thread_local std::vector<key_source<T>> sources = [ ] ( ) {
 
-		const T x = iu::make_odd ( getRandom<std::uint64_t> ( ) );
+		std::vector<key_source<T>> s;
 
-		if ( iu::hash ( iu::hash ( x, m1_ ), m2_ ) != x ) {
+		for ( std::uint32_t d = 0; d < std::uint32_t ( key_distribution::count ); ++d ) {
 
-			return false;
+			s.emplace_back ( key_distribution ( d ), g_rng, getKeyReplay<T> ( ) );
 		}
-	}
 
-	return true;
+		return s;
+	} ( );
+
+	return sources [ std::uint32_t ( d_ ) ].next ( g_rng, buffer_, n_ );
 }
 
+constexpr std::size_t key_batch_size = 1'024;
 
-int32_t main455435 ( ) {
 
-	const char format_string [ ] { " %10u - 0x%016llX 0x%016llX - %.10f\n" };
+template<typename T>
+struct mixer_family;
 
-	uint64_t best_m = iu::make_odd ( getRandom<std::uint64_t> ( ) );
+// A variant of the mixer family, picked at run time. The scorers take it as
+// they take a mixer, its batches go through the tables of mixer_family, an
+// indirect call a batch, so that the scorers are instantiated once a width
+// and only the batch kernels once a variant...
 
-	double avg_ksacd = getCombinedKsacMSR ( best_m, 500 );
-	uint64_t a_cnt = 1;
+template<typename T>
+struct family_mixer {
 
-	double best_ksacd = getCombinedKsacMSR ( best_m, 50'000 );
+	using value_type = T;
+
+	T m1, m2;
+	std::uint32_t variant;
+};
 
-	printf ( format_string, 0u, best_m, iu::mod_mul_inv ( best_m ), best_ksacd );
+namespace inthashing {
 
-	for ( uint32_t i = 1; i < UINT32_MAX; ++i ) {
+	template<typename T>
+	void hashBatch ( const family_mixer<T> & h_, const T * x_, T * y_, const std::size_t n_ ) noexcept {
 
-		const uint64_t m = iu::make_odd ( getRandom<std::uint64_t> ( ) );
+		mixer_family<T>::hashes [ h_.variant ] ( h_.m1, h_.m2, x_, y_, n_ );
+	}
 
-		const double a_ksacd = getCombinedKsacMSR ( m, 500 );
+	template<typename T>
+	void popcountHistogram ( const family_mixer<T> & h_, const T * x_, const T * y_, const std::size_t n_, std::uint64_t * bins_ ) noexcept {
 
-		if ( a_ksacd < avg_ksacd ) {
+		std::uint64_t * const bins [ 1 ] = { bins_ };
 
-			avg_ksacd += ( a_ksacd - avg_ksacd ) / ++a_cnt;
+		mixer_family<T>::blocks [ h_.variant ] ( & h_.m1, & h_.m2, 1, x_, y_, n_, bins );
+	}
+}
 
-			const double b_ksacd = getCombinedKsacMSR ( m, 50'000 );
 
-			if ( b_ksacd < best_ksacd ) {
+// Batched Ksac of any mixer, i_ samples from each distribution in the mix
+// into histogram_, 64-bit mixers go through the vectorized kernel...
 
-				best_m = m;
-				best_ksacd = b_ksacd;
+template<typename H>
+void addKsacHistogram ( const H & h_, const size_t i_, popcount_histogram<typename H::value_type> & histogram_ ) {
 
-				printf ( format_string, i, best_m, iu::mod_mul_inv ( m ), best_ksacd );
-			}
+	using T = typename H::value_type;
+
+	alignas ( 64 ) T x [ key_batch_size ], y [ key_batch_size ];
+
+	for ( const key_distribution d : g_key_mix ) {
+
+		for ( std::size_t i = 0; i < i_; i += key_batch_size ) {
+
+			const std::size_t n = std::min ( key_batch_size, i_ - i );
+
+			const T * keys = getKeys ( d, x, n );
+
+			flipRandomBits ( keys, y, n );
+
+			inthashing::popcountHistogram ( h_, keys, y, n, histogram_.bins ( ) );
 		}
 	}
+}
 
-	return 0;
+template<typename H>
+double getMixerKsacMSR ( const H & h_, const size_t i_ ) {
+
+	popcount_histogram<typename H::value_type> histogram;
+
+	addKsacHistogram ( h_, i_, histogram );
+
+	return histogram.msr ( );
 }
 
-template<typename T>
-struct candidate {
+double getCombinedKsacMSR ( const std::uint64_t m_, const size_t i_ ) {
 
-	T value;
-	std::size_t eval_unit, evaluations, ctr = 1;
-	double score;
+	return getMixerKsacMSR ( inthashing::classic_mixer<std::uint64_t> { { m_, m_ } }, i_ );
+}
 
-	candidate ( ) : value ( iu::make_odd ( getRandom<std::uint64_t> ( ) ) ), eval_unit ( 6 * 1'024 ), evaluations ( 0 ), score ( getCombinedKsacMSR ( value, eval_unit ) ) { }
-	candidate ( const T v_, const std::size_t e_ ) : value ( v_ ), evaluations ( e_ ), score ( getCombinedKsacMSR ( value, evaluations ) ) { }
 
-	void evaluate ( ) noexcept {
+// Feeds matrix_ ( an avalanche_matrix or a bic_matrix ) with the output
+// differences of every single input bit flip. i_ is a budget in Ksac
+// samples (two hashes each) per distribution in the mix, so that this costs
+// about as much as getMixerKsacMSR ( h_, i_ ) in hashes...
 
-		evaluations += eval_unit;
-		score += ( getCombinedKsacMSR ( value, eval_unit ) - score ) / ++ctr;
-	}
+template<typename H, typename M>
+void addFlipSamples ( const H & h_, M & matrix_, const std::size_t i_ ) {
 
-	bool operator < ( candidate & rhs_ ) noexcept {
+	using T = typename H::value_type;
 
-		return score < rhs_.score;
-	}
+	constexpr std::uint32_t bits = M::bits;
 
-	static constexpr std::size_t max ( ) { return 1024 * 1024 * 4; }
-};
+	T buffer [ key_batch_size ], x [ bits + 1 ], h [ bits + 1 ]; // the flips, then the key
 
-int32_t main ( ) {
+	const std::size_t n = std::max<std::size_t> ( 1, ( 2 * i_ ) / ( bits + 1 ) );
 
-	/*
-	const std::uint64_t tested = 0x39FF916554A55555, initial = 0x0CF3FD1B9997F637;
+	for ( const key_distribution d : g_key_mix ) {
 
-	std::uint64_t cnt = ~0ULL - 1ULL, value = initial;
+		for ( std::size_t i = 0; i < n; i += key_batch_size ) {
 
-	while ( cnt-- ) {
+			const std::size_t m = std::min ( key_batch_size, n - i );
 
-		value *= tested;
+			const T * keys = getKeys ( d, buffer, m );
 
-		if ( value == initial ) {
+			for ( std::size_t k = 0; k < m; ++k ) {
 
-			std::cout << "cycle after " << ( ~0ULL - cnt ) << '\n';
+				for ( std::uint32_t b = 0; b < bits; ++b ) {
 
-			exit ( 0 );
+					x [ b ] = flipBit ( keys [ k ], b );
+				}
+
+				x [ bits ] = keys [ k ];
+
+				inthashing::hashBatch ( h_, x, h, bits + 1 );
+
+				for ( std::uint32_t b = 0; b < bits; ++b ) {
+
+					h [ b ] ^= h [ bits ];
+				}
+
+				matrix_.add ( h );
+			}
 		}
 	}
 
-	std::cout << "no cycles\n";
+	matrix_.flush ( );
+}
+
+enum class score_kind : std::uint32_t { ksac_msr, bias_rms, bias_max, bic_rms, bic_max, differential_msr, differential_max };
 
-	exit ( 0 );
-	*/
+// Full avalanche matrix, the rms or the worst | 2p - 1 |...
 
-	using int_type = std::uint64_t;
+template<typename H>
+double getBiasMatrixScore ( const H & h_, const std::size_t i_, const score_kind kind_ ) {
 
-	const char format_string [ ] { " %10u - 0x%016llX 0x%016llX - %.10f - %20llu\n" };
+	avalanche_matrix<typename H::value_type> matrix;
 
-	constexpr std::size_t pop_size = 16 * 1024;
+	addFlipSamples ( h_, matrix, i_ );
 
-	std::vector<candidate<int_type>> population ( pop_size );
-	population.reserve ( pop_size );
+	return kind_ == score_kind::bias_max ? matrix.max_bias ( ) : matrix.rms_bias ( );
+}
 
-	std::sort ( std::begin ( population ), std::end ( population ) );
+// The bic_matrix of the thread, one per width, not per mixer (variant), it's
+// 1.2 MB at 64 bits...
 
-	for ( std::uint32_t i = 0; ; ++i ) {
+template<typename T>
+bic_matrix<T> & bicMatrix ( ) {
 
-		for ( auto & p : population ) {
+	thread_local bic_matrix<T> matrix;
 
-			p.evaluate ( );
-		}
+	return matrix;
+}
 
-		std::sort ( std::begin ( population ), std::end ( population ) );
+// Bit independence, the rms or the worst correlation of two output bit
+// flips...
 
-		// printf ( format_string, i, population [ 0 ].value, 0ULL, population [ 0 ].score, population [ 0 ].evaluations );
+template<typename H>
+double getBicScore ( const H & h_, const std::size_t i_, const score_kind kind_ ) {
 
-		printf ( format_string, i, ( std::uint64_t ) population [ 0 ].value, ( std::uint64_t ) iu::mod_mul_inv ( population [ 0 ].value ), population [ 0 ].score, population [ 0 ].evaluations );
-		printf ( format_string, i, ( std::uint64_t ) population [ 1 ].value, ( std::uint64_t ) iu::mod_mul_inv ( population [ 1 ].value ), population [ 1 ].score, population [ 1 ].evaluations );
-		printf ( format_string, i, ( std::uint64_t ) population [ 2 ].value, ( std::uint64_t ) iu::mod_mul_inv ( population [ 2 ].value ), population [ 2 ].score, population [ 2 ].evaluations );
+	bic_matrix<typename H::value_type> & matrix = bicMatrix<typename H::value_type> ( );
 
-		std::cout << std::endl;
+	matrix.clear ( );
 
-		std::size_t m = pop_size * 0.6f;
+	addFlipSamples ( h_, matrix, i_ );
 
-		while ( m < pop_size ) {
+	return kind_ == score_kind::bic_max ? matrix.max_correlation ( ) : matrix.rms_correlation ( );
+}
 
-			population [ m++ ] = candidate<int_type> { };
-		}
-	}
+// Multi-bit input differences, see differentials.hpp. The set is the same
+// for every candidate (fixed seed), every batch of keys goes through all of
+// the differences...
 
-	return 0;
+template<typename T>
+const std::vector<inthashing::input_difference<T>> & getDifferences ( ) {
+
+	static const std::vector<inthashing::input_difference<T>> differences = [ ] ( ) {
+
+		jimi::XoRoShiRo128Plus rng ( 0x243F6A8885A308D3 );
+
+		return inthashing::makeDifferences<T> ( rng, sizeof ( T ) * 8, 32 );
+	} ( );
+
+	return differences;
+}
+
+struct differential_result {
+
+	double mean, worst; // Ksac style mean squared error, over all differences and of the worst one
+	std::size_t worst_index; // into getDifferences ( )
+};
+
+// The Ksac squared deviation of hashes hx_ and hy_ of keys one difference
+// apart...
+
+template<typename T>
+std::uint64_t getDifferentialSquaredDeviation ( const T * hx_, const T * hy_, const std::size_t n_ ) noexcept {
+
+	std::uint64_t sum = 0;
+
+	for ( std::size_t i = 0; i < n_; ++i ) {
+
+		const std::int64_t d = std::int64_t ( inthashing::detail::popcnt ( T ( hx_ [ i ] ^ hy_ [ i ] ) ) ) - std::int64_t ( sizeof ( T ) * 4 );
+
+		sum += std::uint64_t ( d * d );
+	}
+
+	return sum;
+}
+
+// i_ samples per distribution in the mix, spread over the differences.
+// hash_ ( x, y, n ) hashes a batch of keys. The keys are hashed once a
+// batch, for all of the differences. The worst of 32 noisy means is biased
+// up, it's sampled again, on fresh keys, before it's reported...
+
+template<typename T, typename H>
+differential_result getDifferentialMSR ( const H & hash_, const std::size_t i_ ) {
+
+	const std::vector<inthashing::input_difference<T>> & differences = getDifferences<T> ( );
+
+	const std::size_t n = std::max<std::size_t> ( 8, i_ / differences.size ( ) );
+
+	alignas ( 64 ) T buffer [ key_batch_size ], y [ key_batch_size ], hx [ key_batch_size ], hy [ key_batch_size ];
+
+	const auto sample = [ & ] ( const std::size_t j_, const T * keys_, const std::size_t m_ ) {
+
+		inthashing::applyDifference ( differences [ j_ ], keys_, y, m_ );
+
+		hash_ ( y, hy, m_ );
+
+		return getDifferentialSquaredDeviation ( hx, hy, m_ );
+	};
+
+	std::vector<std::uint64_t> sums ( differences.size ( ), 0 );
+
+	for ( const key_distribution d : g_key_mix ) {
+
+		for ( std::size_t i = 0; i < n; i += key_batch_size ) {
+
+			const std::size_t m = std::min ( key_batch_size, n - i );
+
+			const T * keys = getKeys ( d, buffer, m );
+
+			hash_ ( keys, hx, m );
+
+			for ( std::size_t j = 0; j < differences.size ( ); ++j ) {
+
+				sums [ j ] += sample ( j, keys, m );
+			}
+		}
+	}
+
+	const std::size_t worst = std::size_t ( std::max_element ( std::begin ( sums ), std::end ( sums ) ) - std::begin ( sums ) );
+
+	std::uint64_t confirmed = 0;
+
+	for ( const key_distribution d : g_key_mix ) {
+
+		for ( std::size_t i = 0; i < n; i += key_batch_size ) {
+
+			const std::size_t m = std::min ( key_batch_size, n - i );
+
+			const T * keys = getKeys ( d, buffer, m );
+
+			hash_ ( keys, hx, m );
+
+			confirmed += sample ( worst, keys, m );
+		}
+	}
+
+	const double norm = double ( g_key_mix.size ( ) * n ) * double ( sizeof ( T ) * 8 ) * double ( sizeof ( T ) * 8 );
+
+	return { double ( std::accumulate ( std::begin ( sums ), std::end ( sums ), std::uint64_t ( 0 ) ) ) / ( norm * double ( sums.size ( ) ) ), double ( confirmed ) / norm, worst };
+}
+
+template<typename H>
+differential_result getDifferentialMSR ( const H & h_, const std::size_t i_ ) {
+
+	using T = typename H::value_type;
+
+	return getDifferentialMSR<T> ( [ & ] ( const T * x_, T * y_, const std::size_t n_ ) { inthashing::hashBatch ( h_, x_, y_, n_ ); }, i_ );
+}
+
+// The score the search ranks candidates by, lower is better. With a
+// g_bic_weight > 0, the mean squared BIC correlation, times the weight, is
+// added to the other scores (its budget is a quarter of theirs),
+// output bits that flip together cluster in hash tables...
+
+score_kind g_score_kind = score_kind::ksac_msr;
+double g_bic_weight = 0.0;
+
+template<typename H>
+double getMixerScore ( const H & h_, const std::size_t i_ ) {
+
+	double score;
+
+	switch ( g_score_kind ) {
+
+		case score_kind::bias_rms:
+		case score_kind::bias_max:
+
+			score = getBiasMatrixScore ( h_, i_, g_score_kind );
+
+			break;
+
+		case score_kind::bic_rms:
+		case score_kind::bic_max:
+
+			return getBicScore ( h_, i_, g_score_kind );
+
+		case score_kind::differential_msr:
+
+			score = getDifferentialMSR ( h_, i_ ).mean;
+
+			break;
+
+		case score_kind::differential_max:
+
+			score = getDifferentialMSR ( h_, i_ ).worst;
+
+			break;
+
+		default:
+
+			score = getMixerKsacMSR ( h_, i_ );
+	}
+
+	if ( g_bic_weight > 0.0 ) {
+
+		const double c = getBicScore ( h_, i_ / 4, score_kind::bic_rms );
+
+		score += g_bic_weight * c * c;
+	}
+
+	return score;
+}
+
+template<typename T>
+double getScore ( const T m_, const std::size_t i_ ) {
+
+	return getMixerScore ( inthashing::classic_mixer<T> { { m_, m_ } }, i_ );
+}
+
+
+// The searched mixer family: all combinations of 7 shifts, around half the
+// width, for each of S1, S2 and S3, with 2 or 3 rounds. Every variant is its
+// own instantiation of the batch kernels (immediate shifts in the hot loop),
+// the tables map the variant number to them, the scorers get at them
+// through a family_mixer...
+
+template<typename T>
+struct mixer_family {
+
+	static constexpr std::uint32_t shifts = 7, size = 2 * shifts * shifts * shifts;
+
+	static constexpr std::uint32_t shift ( const std::uint32_t i_ ) noexcept {
+
+		return sizeof ( T ) > 1 ? std::uint32_t ( sizeof ( T ) * 4 - 5 ) + i_ : 1 + i_;
+	}
+
+	// variant = ( ( ( rounds - 2 ) * shifts + s1 ) * shifts + s2 ) * shifts + s3, the s's are shift indices...
+
+	static constexpr std::uint32_t variant ( const std::uint32_t rounds_, const std::uint32_t i1_, const std::uint32_t i2_, const std::uint32_t i3_ ) noexcept {
+
+		return ( ( ( rounds_ - 2 ) * shifts + i1_ ) * shifts + i2_ ) * shifts + i3_;
+	}
+
+	static constexpr std::uint32_t index1 ( const std::uint32_t v_ ) noexcept { return v_ / ( shifts * shifts ) % shifts; }
+	static constexpr std::uint32_t index2 ( const std::uint32_t v_ ) noexcept { return v_ / shifts % shifts; }
+	static constexpr std::uint32_t index3 ( const std::uint32_t v_ ) noexcept { return v_ % shifts; }
+
+	static constexpr std::uint32_t shift1 ( const std::uint32_t v_ ) noexcept { return shift ( index1 ( v_ ) ); }
+	static constexpr std::uint32_t shift2 ( const std::uint32_t v_ ) noexcept { return shift ( index2 ( v_ ) ); }
+	static constexpr std::uint32_t shift3 ( const std::uint32_t v_ ) noexcept { return shift ( index3 ( v_ ) ); }
+	static constexpr std::uint32_t rounds ( const std::uint32_t v_ ) noexcept { return 2 + v_ / ( shifts * shifts * shifts ); }
+
+	// The variant of inthashing::hash ( ), 3 x half the width, 2 rounds...
+
+	static constexpr std::uint32_t classic ( ) noexcept {
+
+		return ( ( sizeof ( T ) > 1 ? 5 : 3 ) * shifts + ( sizeof ( T ) > 1 ? 5 : 3 ) ) * shifts + ( sizeof ( T ) > 1 ? 5 : 3 );
+	}
+
+	template<std::uint32_t V>
+	using type = inthashing::mixer<T, shift1 ( V ), shift2 ( V ), shift3 ( V ), rounds ( V )>;
+
+	// Adds the same n_ Ksac pairs to the histograms of count_ candidates, for
+	// common random numbers evaluation, a count_ of 1 for the scorers...
+
+	using block_function = void ( * ) ( const T * m1_, const T * m2_, const std::size_t count_, const T * x_, const T * y_, const std::size_t n_, std::uint64_t * const * bins_ );
+
+	static constexpr std::size_t block_size = 16;
+
+	template<std::uint32_t V>
+	static void block ( const T * m1_, const T * m2_, const std::size_t count_, const T * x_, const T * y_, const std::size_t n_, std::uint64_t * const * bins_ ) noexcept {
+
+		type<V> h [ block_size ];
+
+		for ( std::size_t c = 0; c < count_; ++c ) {
+
+			h [ c ] = { { m1_ [ c ], m2_ [ c ] } };
+		}
+
+		inthashing::popcountHistograms ( h, count_, x_, y_, n_, bins_ );
+	}
+
+	template<std::uint32_t ... V>
+	static constexpr std::array<block_function, size> makeBlockTable ( std::integer_sequence<std::uint32_t, V ...> ) noexcept {
+
+		return { { & block<V> ... } };
+	}
+
+	static constexpr std::array<block_function, size> blocks = makeBlockTable ( std::make_integer_sequence<std::uint32_t, size> ( ) );
+
+	// Hashes n_ keys, for the scorers and the test battery...
+
+	using hash_function = void ( * ) ( const T m1_, const T m2_, const T * x_, T * y_, const std::size_t n_ );
+
+	template<std::uint32_t V>
+	static void hash ( const T m1_, const T m2_, const T * x_, T * y_, const std::size_t n_ ) noexcept {
+
+		inthashing::hashBatch ( type<V> { { m1_, m2_ } }, x_, y_, n_ );
+	}
+
+	template<std::uint32_t ... V>
+	static constexpr std::array<hash_function, size> makeHashTable ( std::integer_sequence<std::uint32_t, V ...> ) noexcept {
+
+		return { { & hash<V> ... } };
+	}
+
+	static constexpr std::array<hash_function, size> hashes = makeHashTable ( std::make_integer_sequence<std::uint32_t, size> ( ) );
+};
+
+// Search the whole mixer family (random shifts, rounds and two independent
+// multipliers), instead of only the classic single multiplier form...
+
+bool g_search_mixer_family = false;
+
+
+// The inverse of odd m_ mod 2^w, for any width...
+
+template<typename T>
+constexpr T getInverse ( const T m_ ) noexcept {
+
+	return inthashing::modularInverse ( m_ );
+}
+
+// Whether unhash_ undoes hash_ (and hash_ is a permutation), batch functions
+// ( x, y, n ), for every input up to 32 bits, see bijection.hpp. Beyond
+// that, for 2^30 random inputs, on the worker pool...
+
+template<typename T, typename Hash, typename UnHash>
+bool isInverse ( const Hash & hash_, const UnHash & unhash_ ) {
+
+	if constexpr ( sizeof ( T ) <= 4 ) {
+
+		const inthashing::bijection_result r = inthashing::verifyBijection<T> ( hash_, unhash_ );
+
+		return r.permutation and r.inverse;
+	}
+
+	else {
+
+		std::atomic<bool> inverse ( true );
+
+		workers ( ).parallel_for ( std::size_t ( 1 ) << 20, [ & ] ( const std::size_t ) {
+
+			T x [ key_batch_size ], y [ key_batch_size ], z [ key_batch_size ];
+
+			for ( T & k : x ) {
+
+				k = getRandom<T> ( );
+			}
+
+			hash_ ( x, y, key_batch_size );
+			unhash_ ( y, z, key_batch_size );
+
+			if ( not std::equal ( x, x + key_batch_size, z ) ) {
+
+				inverse.store ( false, std::memory_order_relaxed );
+			}
+		}, 64 );
+
+		return inverse.load ( );
+	}
+}
+
+// Whether the classic mixer with m2_ undoes the one with m1_...
+
+template<typename T>
+bool isInverse ( const T m1_, const T m2_ ) {
+
+	const auto batch = [ ] ( const T m_ ) {
+
+		return [ m_ ] ( const T * x_, T * y_, const std::size_t n_ ) { mixer_family<T>::hashes [ mixer_family<T>::classic ( ) ] ( m_, m_, x_, y_, n_ ); };
+	};
+
+	return isInverse<T> ( batch ( m1_ ), batch ( m2_ ) );
+}
+
+
+// Standalone: random restarts, a quick score to screen, a long one for
+// the best so far...
+
+template<typename T>
+int mainRandomSearch ( ) {
+
+	const char format_string [ ] { " %10u - %s %s - %.10f\n" };
+
+	T best_m = iu::make_odd ( getRandom<T> ( ) );
+
+	double avg_ksacd = getCombinedKsacMSR ( best_m, 500 );
+	uint64_t a_cnt = 1;
+
+	double best_ksacd = getCombinedKsacMSR ( best_m, 50'000 );
+
+	printf ( format_string, 0u, hexString ( best_m ).c_str ( ), hexString ( getInverse ( best_m ) ).c_str ( ), best_ksacd );
+
+	for ( uint32_t i = 1; i < UINT32_MAX; ++i ) {
+
+		const T m = iu::make_odd ( getRandom<T> ( ) );
+
+		const double a_ksacd = getCombinedKsacMSR ( m, 500 );
+
+		if ( a_ksacd < avg_ksacd ) {
+
+			avg_ksacd += ( a_ksacd - avg_ksacd ) / ++a_cnt;
+
+			const double b_ksacd = getCombinedKsacMSR ( m, 50'000 );
+
+			if ( b_ksacd < best_ksacd ) {
+
+				best_m = m;
+				best_ksacd = b_ksacd;
+
+				printf ( format_string, i, hexString ( best_m ).c_str ( ), hexString ( getInverse ( m ) ).c_str ( ), best_ksacd );
+			}
+		}
+	}
+
+	return 0;
+}
+
+// The key distributions of the mix as a bit set, part of the key of a score
+// in the score database...
+
+std::uint32_t keyMixBits ( ) noexcept {
+
+	std::uint32_t bits = 0;
+
+	for ( const key_distribution d : g_key_mix ) {
+
+		bits |= 1u << std::uint32_t ( d );
+	}
+
+	return bits;
+}
+
+template<typename T>
+score_db<T> & scoreDb ( ) {
+
+	static score_db<T> db;
+
+	return db;
+}
+
+// The plain Ksac MSR is scored through histograms: a candidate's score and
+// its confidence interval follow from all its samples, exactly, whatever the
+// order of the evaluations...
+
+inline bool exactScoring ( ) noexcept {
+
+	return g_score_kind == score_kind::ksac_msr and g_bic_weight == 0.0;
+}
+
+// Candidates are drawn (and bred) inside the region of the prefilter, see
+// prefilter.hpp, which learnPrefilter ( ) fits to the score database...
+
+bool g_use_prefilter = false;
+inthashing::prefilter_thresholds g_prefilter = inthashing::emptyPrefilter<std::uint64_t> ( ); // set by mainSearch ( )
+
+std::atomic<std::uint64_t> g_prefilter_tested ( 0 ), g_prefilter_rejected ( 0 );
+
+template<typename T>
+bool passesPrefilter ( const T m_ ) noexcept {
+
+	if ( not g_use_prefilter ) {
+
+		return true;
+	}
+
+	g_prefilter_tested.fetch_add ( 1, std::memory_order_relaxed );
+
+	if ( g_prefilter.passes ( inthashing::getMultiplierFeatures ( m_ ) ) ) {
+
+		return true;
+	}
+
+	g_prefilter_rejected.fetch_add ( 1, std::memory_order_relaxed );
+
+	return false;
+}
+
+template<typename T>
+T getPrefilteredMultiplier ( ) noexcept {
+
+	T m;
+
+	do {
+
+		m = iu::make_odd ( getRandom<T> ( ) );
+	} while ( not passesPrefilter ( m ) );
+
+	return m;
+}
+
+// Ksac samples per evaluate ( ), per key distribution...
+
+std::size_t g_eval_unit = 6 * 1'024;
+
+template<typename T>
+struct candidate {
+
+	T value, value2; // the multipliers of the first and second round, equal in the classic form
+	std::uint32_t variant = mixer_family<T>::classic ( );
+	std::size_t eval_unit, evaluations, ctr = 1;
+	double score, m2 = 0.0; // running mean and sum of squared deviations (Welford) of the evaluate ( ) scores
+	popcount_histogram<T> histogram; // instead, for the plain Ksac MSR, see exactScoring ( )
+
+	// Unscored, the first evaluate ( ) sets the score, so that the (expensive)
+	// scoring can be done by the worker pool...
+
+	candidate ( ) : value ( getPrefilteredMultiplier<T> ( ) ), value2 ( value ), eval_unit ( g_eval_unit ), evaluations ( 0 ), ctr ( 0 ), score ( 0.0 ) {
+
+		if ( g_search_mixer_family ) {
+
+			value2 = getPrefilteredMultiplier<T> ( );
+			variant = boost::random::uniform_int_distribution<std::uint32_t> ( 0, mixer_family<T>::size - 1 ) ( g_rng );
+		}
+	}
+
+	// Unscored, as it comes out of a population...
+
+	candidate ( const T v_, const T v2_, const std::uint32_t variant_, const std::size_t eval_unit_ ) : value ( v_ ), value2 ( v2_ ), variant ( variant_ ), eval_unit ( eval_unit_ ), evaluations ( 0 ), ctr ( 0 ), score ( 0.0 ) { }
+
+	// One score sample, over i_ Ksac samples worth of hashing...
+
+	double measure ( const std::size_t i_ ) const {
+
+		return getMixerScore ( family_mixer<T> { value, value2, variant }, i_ );
+	}
+
+	void evaluate ( ) {
+
+		evaluations += eval_unit;
+
+		if ( exactScoring ( ) ) {
+
+			addKsacHistogram ( family_mixer<T> { value, value2, variant }, eval_unit, histogram );
+
+			++ctr;
+			score = histogram.msr ( );
+
+			return;
+		}
+
+		const double s = measure ( eval_unit ), d = s - score;
+
+		score += d / ++ctr;
+		m2 += d * ( s - score );
+	}
+
+	// Books an evaluation whose samples evaluateBlock ( ) put in the histogram...
+
+	void evaluated ( ) noexcept {
+
+		evaluations += eval_unit;
+		++ctr;
+		score = histogram.msr ( );
+	}
+
+	// Picks up the histogram earlier runs left in the score database, if it
+	// knows this candidate...
+
+	void recall ( ) {
+
+		if ( not exactScoring ( ) or not scoreDb<T> ( ).is_open ( ) ) {
+
+			return;
+		}
+
+		if ( const score_db_record<T> * r = scoreDb<T> ( ).find ( value, value2, variant, keyMixBits ( ) ) ) {
+
+			std::copy ( r->histogram, r->histogram + popcount_histogram<T>::size, histogram.bins ( ) );
+
+			evaluations = std::size_t ( r->evaluations );
+			ctr = std::max<std::size_t> ( 1, evaluations / eval_unit );
+			score = histogram.msr ( );
+		}
+	}
+
+	score_db_record<T> record ( ) const {
+
+		score_db_record<T> r { value, value2, getInverse ( value ), getInverse ( value2 ), variant, keyMixBits ( ), evaluations, { } };
+
+		std::copy ( histogram.bins ( ), histogram.bins ( ) + popcount_histogram<T>::size, r.histogram );
+
+		return r;
+	}
+
+	// Confidence interval of the mean score, z_ standard errors wide, needs
+	// at least two evaluations...
+
+	double standard_error ( ) const noexcept {
+
+		return histogram.samples ( ) ? histogram.standard_error ( ) : std::sqrt ( m2 / double ( ( ctr - 1 ) * ctr ) );
+	}
+
+	double lower ( const double z_ ) const noexcept {
+
+		return score - z_ * standard_error ( );
+	}
+
+	double upper ( const double z_ ) const noexcept {
+
+		return score + z_ * standard_error ( );
+	}
+
+	bool operator < ( candidate & rhs_ ) noexcept {
+
+		return score < rhs_.score;
+	}
+
+	static constexpr std::size_t max ( ) { return 1024 * 1024 * 4; }
+};
+
+constexpr double race_z = 3.0;
+
+
+// The population, structure of arrays: the multipliers, the scores, the
+// counters and the histograms each in an array of their own, cache line
+// aligned, so the selection and the confidence bounds stream over just the
+// fields they read. candidate<T> is the value type going in and out, a
+// candidate is replaced in place by set ( )...
+
+template<typename T>
+class population {
+
+	template<typename U>
+	using aligned_vector = std::vector<U, boost::alignment::aligned_allocator<U, 64>>;
+
+	static constexpr std::size_t bins_size = popcount_histogram<T>::size;
+
+	aligned_vector<T> m_values, m_values2;
+	aligned_vector<std::uint32_t> m_variants;
+	aligned_vector<std::uint64_t> m_evaluations, m_ctrs;
+	aligned_vector<double> m_scores, m_m2s, m_errors; // m_errors caches the standard error
+	aligned_vector<std::uint64_t> m_bins; // [ size ] [ bins_size ]
+
+	std::size_t m_eval_unit = 0; // the same for all, taken from the candidates push_back ( ) adds, set ( ) runs in parallel
+
+public:
+
+	population ( ) = default;
+
+	// n_ fresh (unscored) candidates...
+
+	explicit population ( const std::size_t n_ ) {
+
+		reserve ( n_ );
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			push_back ( candidate<T> ( ) );
+		}
+	}
+
+	std::size_t size ( ) const noexcept {
+
+		return m_values.size ( );
+	}
+
+	void reserve ( const std::size_t n_ ) {
+
+		m_values.reserve ( n_ );
+		m_values2.reserve ( n_ );
+		m_variants.reserve ( n_ );
+		m_evaluations.reserve ( n_ );
+		m_ctrs.reserve ( n_ );
+		m_scores.reserve ( n_ );
+		m_m2s.reserve ( n_ );
+		m_errors.reserve ( n_ );
+		m_bins.reserve ( n_ * bins_size );
+	}
+
+	void push_back ( const candidate<T> & c_ ) {
+
+		m_values.emplace_back ( );
+		m_values2.emplace_back ( );
+		m_variants.emplace_back ( );
+		m_evaluations.emplace_back ( );
+		m_ctrs.emplace_back ( );
+		m_scores.emplace_back ( );
+		m_m2s.emplace_back ( );
+		m_errors.emplace_back ( );
+		m_bins.resize ( m_bins.size ( ) + bins_size );
+
+		m_eval_unit = c_.eval_unit;
+
+		set ( size ( ) - 1, c_ );
+	}
+
+	candidate<T> get ( const std::size_t i_ ) const {
+
+		candidate<T> c ( m_values [ i_ ], m_values2 [ i_ ], m_variants [ i_ ], m_eval_unit );
+
+		c.evaluations = std::size_t ( m_evaluations [ i_ ] );
+		c.ctr = std::size_t ( m_ctrs [ i_ ] );
+		c.score = m_scores [ i_ ];
+		c.m2 = m_m2s [ i_ ];
+
+		std::copy ( bins ( i_ ), bins ( i_ ) + bins_size, c.histogram.bins ( ) );
+
+		return c;
+	}
+
+	void set ( const std::size_t i_, const candidate<T> & c_ ) {
+
+		m_values [ i_ ] = c_.value;
+		m_values2 [ i_ ] = c_.value2;
+		m_variants [ i_ ] = c_.variant;
+		m_evaluations [ i_ ] = c_.evaluations;
+		m_ctrs [ i_ ] = c_.ctr;
+		m_scores [ i_ ] = c_.score;
+		m_m2s [ i_ ] = c_.m2;
+		m_errors [ i_ ] = c_.ctr > 1 or c_.histogram.samples ( ) ? c_.standard_error ( ) : 0.0;
+
+		std::copy ( c_.histogram.bins ( ), c_.histogram.bins ( ) + bins_size, bins ( i_ ) );
+	}
+
+	T value ( const std::size_t i_ ) const noexcept { return m_values [ i_ ]; }
+	T value2 ( const std::size_t i_ ) const noexcept { return m_values2 [ i_ ]; }
+	std::uint32_t variant ( const std::size_t i_ ) const noexcept { return m_variants [ i_ ]; }
+	std::size_t eval_unit ( ) const noexcept { return m_eval_unit; }
+	std::size_t ctr ( const std::size_t i_ ) const noexcept { return std::size_t ( m_ctrs [ i_ ] ); }
+	double score ( const std::size_t i_ ) const noexcept { return m_scores [ i_ ]; }
+
+	std::uint64_t * bins ( const std::size_t i_ ) noexcept { return m_bins.data ( ) + i_ * bins_size; }
+	const std::uint64_t * bins ( const std::size_t i_ ) const noexcept { return m_bins.data ( ) + i_ * bins_size; }
+
+	double lower ( const std::size_t i_, const double z_ ) const noexcept {
+
+		return m_scores [ i_ ] - z_ * m_errors [ i_ ];
+	}
+
+	double upper ( const std::size_t i_, const double z_ ) const noexcept {
+
+		return m_scores [ i_ ] + z_ * m_errors [ i_ ];
+	}
+
+	// One evaluate ( ) of candidate i_, see candidate<T>::evaluate ( )...
+
+	void evaluate ( const std::size_t i_ ) {
+
+		candidate<T> c = get ( i_ );
+
+		c.evaluate ( );
+
+		set ( i_, c );
+	}
+
+	// Books an evaluation whose samples evaluateBlock ( ) put in bins ( i_ )...
+
+	void evaluated ( const std::size_t i_ ) noexcept {
+
+		m_evaluations [ i_ ] += m_eval_unit;
+		++m_ctrs [ i_ ];
+
+		popcount_histogram<T> histogram;
+
+		std::copy ( bins ( i_ ), bins ( i_ ) + bins_size, histogram.bins ( ) );
+
+		m_scores [ i_ ] = histogram.msr ( );
+		m_errors [ i_ ] = histogram.standard_error ( );
+	}
+
+	// The indices of the n_ lowest scores, best first, by partial selection,
+	// O ( size ( ) + n_ log n_ )...
+
+	std::vector<std::size_t> best ( std::size_t n_ ) const {
+
+		std::vector<std::size_t> indices ( size ( ) );
+
+		std::iota ( std::begin ( indices ), std::end ( indices ), std::size_t ( 0 ) );
+
+		n_ = std::min ( n_, indices.size ( ) );
+
+		std::partial_sort ( std::begin ( indices ), std::begin ( indices ) + n_, std::end ( indices ), [ this ] ( const std::size_t a_, const std::size_t b_ ) { return m_scores [ a_ ] < m_scores [ b_ ]; } );
+
+		indices.resize ( n_ );
+
+		return indices;
+	}
+};
+
+
+// What makes two candidates the same one, the multipliers and the variant.
+// The population holds every key once, a bred child or a climb neighbour
+// already in it would only be scored again...
+
+template<typename T>
+struct candidate_key {
+
+	T value, value2;
+	std::uint32_t variant;
+
+	bool operator == ( const candidate_key & rhs_ ) const noexcept {
+
+		return value == rhs_.value and value2 == rhs_.value2 and variant == rhs_.variant;
+	}
+};
+
+template<typename T>
+struct candidate_key_hash {
+
+	std::size_t operator ( ) ( const candidate_key<T> & k_ ) const noexcept {
+
+		std::uint64_t h = std::uint64_t ( k_.value ) ^ ( std::uint64_t ( k_.value2 ) * 0x9E3779B97F4A7C15 ) ^ ( std::uint64_t ( k_.variant ) * 0xC2B2AE3D27D4EB4F ); // the low 64 bits at 128
+
+		h = ( ( h >> 32 ) ^ h ) * 0x0CF3FD1B9997F637;
+
+		return std::size_t ( ( h >> 32 ) ^ h );
+	}
+};
+
+template<typename T>
+using candidate_keys = std::unordered_set<candidate_key<T>, candidate_key_hash<T>>;
+
+template<typename T>
+candidate_keys<T> getCandidateKeys ( const population<T> & population_ ) {
+
+	candidate_keys<T> keys;
+
+	keys.reserve ( population_.size ( ) );
+
+	for ( std::size_t i = 0; i < population_.size ( ); ++i ) {
+
+		keys.insert ( { population_.value ( i ), population_.value2 ( i ), population_.variant ( i ) } );
+	}
+
+	return keys;
+}
+
+// A duplicate is redrawn, up to this many times, at 8 bits there are only
+// 128 odd multipliers...
+
+constexpr std::uint32_t max_redraws = 64;
+
+
+// Common random numbers: with exact scoring, candidates of the same variant
+// are evaluated in blocks, all of a block against one shared batch of
+// inputs and bit flips, the vector lanes running across the multipliers.
+// The noise of the inputs is then common to the block and drops out of the
+// comparisons within it, and the inputs are drawn once per block...
+
+bool g_common_random_numbers = false;
+
+template<typename T>
+void evaluateBlock ( population<T> & population_, const std::size_t * indices_, const std::size_t n_ ) {
+
+	T m1 [ mixer_family<T>::block_size ], m2 [ mixer_family<T>::block_size ];
+	std::uint64_t * bins [ mixer_family<T>::block_size ];
+
+	for ( std::size_t c = 0; c < n_; ++c ) {
+
+		m1 [ c ] = population_.value ( indices_ [ c ] );
+		m2 [ c ] = population_.value2 ( indices_ [ c ] );
+		bins [ c ] = population_.bins ( indices_ [ c ] );
+	}
+
+	const std::size_t eval_unit = population_.eval_unit ( );
+	const typename mixer_family<T>::block_function block = mixer_family<T>::blocks [ population_.variant ( indices_ [ 0 ] ) ];
+
+	alignas ( 64 ) T x [ key_batch_size ], y [ key_batch_size ];
+
+	for ( const key_distribution d : g_key_mix ) {
+
+		for ( std::size_t i = 0; i < eval_unit; i += key_batch_size ) {
+
+			const std::size_t n = std::min ( key_batch_size, eval_unit - i );
+			const T * keys;
+
+			{
+				const telemetry_scope scope ( telemetry_phase::rng );
+
+				keys = getKeys ( d, x, n );
+
+				flipRandomBits ( keys, y, n );
+			}
+
+			const telemetry_scope scope ( telemetry_phase::scoring );
+
+			block ( m1, m2, n_, keys, y, n, bins );
+		}
+	}
+
+	for ( std::size_t c = 0; c < n_; ++c ) {
+
+		population_.evaluated ( indices_ [ c ] );
+	}
+
+	searchTelemetry ( ).evaluated ( n_ );
+}
+
+// One evaluate ( ) for every candidate in indices_, on the worker pool, in
+// blocks of a variant if common random numbers are on. The blocks follow the
+// order of indices_ (within a variant), so that neighbours there share their
+// inputs...
+
+template<typename T>
+void evaluateAll ( population<T> & population_, const std::vector<std::size_t> & indices_ ) {
+
+	if ( not g_common_random_numbers or not exactScoring ( ) ) {
+
+		workers ( ).parallel_for ( indices_.size ( ), [ & ] ( const std::size_t i ) {
+
+			const telemetry_scope scope ( telemetry_phase::scoring ); // the keys are drawn inside
+
+			population_.evaluate ( indices_ [ i ] );
+
+			searchTelemetry ( ).evaluated ( 1 );
+		} );
+
+		return;
+	}
+
+	std::vector<std::size_t> order ( indices_ );
+
+	std::stable_sort ( std::begin ( order ), std::end ( order ), [ & ] ( const std::size_t a_, const std::size_t b_ ) { return population_.variant ( a_ ) < population_.variant ( b_ ); } );
+
+	std::vector<std::pair<std::size_t, std::size_t>> blocks; // begin, size
+
+	for ( std::size_t b = 0; b < order.size ( ); ) {
+
+		std::size_t e = b + 1;
+
+		while ( e < order.size ( ) and e - b < mixer_family<T>::block_size and population_.variant ( order [ e ] ) == population_.variant ( order [ b ] ) ) {
+
+			++e;
+		}
+
+		blocks.emplace_back ( b, e - b );
+		b = e;
+	}
+
+	workers ( ).parallel_for ( blocks.size ( ), [ & ] ( const std::size_t i ) { evaluateBlock ( population_, order.data ( ) + blocks [ i ].first, blocks [ i ].second ); }, 1 );
+}
+
+
+// Variation operators, all of them keep the multipliers odd...
+
+std::uint32_t getRandomBelow ( const std::uint32_t n_ ) noexcept {
+
+	return boost::random::uniform_int_distribution<std::uint32_t> ( 0, n_ - 1 ) ( g_rng );
+}
+
+// Flips 1 to 3 random bits, never bit 0...
+
+template<typename T>
+T mutateFlipBits ( T v_ ) noexcept {
+
+	for ( std::uint32_t k = 1 + getRandomBelow ( 3 ); k; --k ) {
+
+		v_ = flipBit ( v_, 1 + getRandomBelow ( sizeof ( T ) * 8 - 1 ) );
+	}
+
+	return v_;
+}
+
+template<typename T>
+T mutateRotate ( const T v_ ) noexcept {
+
+	const std::uint32_t r = 1 + getRandomBelow ( sizeof ( T ) * 8 - 1 );
+
+	return iu::make_odd ( T ( ( v_ << r ) | ( v_ >> ( sizeof ( T ) * 8 - r ) ) ) );
+}
+
+// Adds or subtracts a small even number (the sum stays odd)...
+
+template<typename T>
+T mutateAdd ( const T v_ ) noexcept {
+
+	const T delta = T ( 2 * ( 1 + getRandomBelow ( 16 ) ) );
+
+	return getRandomBelow ( 2 ) ? T ( v_ + delta ) : T ( v_ - delta );
+}
+
+template<typename T>
+T mutate ( const T v_ ) noexcept {
+
+	switch ( getRandomBelow ( 3 ) ) {
+
+		case 0: return mutateFlipBits ( v_ );
+		case 1: return mutateRotate ( v_ );
+		default: return mutateAdd ( v_ );
+	}
+}
+
+// Takes every bit from a or b, as a random mask says...
+
+template<typename T>
+T crossoverMask ( const T a_, const T b_ ) noexcept {
+
+	const T mask = getRandom<T> ( );
+
+	return iu::make_odd ( T ( ( a_ & mask ) | ( b_ & ~mask ) ) );
+}
+
+// The high bits of a, the low bits of b, cut at a random bit...
+
+template<typename T>
+T crossoverSplice ( const T a_, const T b_ ) noexcept {
+
+	const T low = T ( ( T ( 1 ) << ( 1 + getRandomBelow ( sizeof ( T ) * 8 - 1 ) ) ) - 1 );
+
+	return iu::make_odd ( T ( ( a_ & ~low ) | ( b_ & low ) ) );
+}
+
+template<typename T>
+T crossover ( const T a_, const T b_ ) noexcept {
+
+	return getRandomBelow ( 2 ) ? crossoverMask ( a_, b_ ) : crossoverSplice ( a_, b_ );
+}
+
+// Moves one of the shifts one step, or toggles the number of rounds...
+
+template<typename T>
+std::uint32_t mutateVariant ( const std::uint32_t v_ ) noexcept {
+
+	using F = mixer_family<T>;
+
+	std::uint32_t i [ 3 ] = { F::index1 ( v_ ), F::index2 ( v_ ), F::index3 ( v_ ) }, rounds = F::rounds ( v_ );
+
+	const std::uint32_t field = getRandomBelow ( 4 );
+
+	if ( field == 3 ) {
+
+		rounds = 5 - rounds;
+	}
+
+	else {
+
+		i [ field ] = i [ field ] == 0 ? 1 : i [ field ] == F::shifts - 1 ? F::shifts - 2 : i [ field ] + ( getRandomBelow ( 2 ) ? 1 : -1 );
+	}
+
+	return F::variant ( rounds, i [ 0 ], i [ 1 ], i [ 2 ] );
+}
+
+
+// A replacement candidate: half of them fresh random ones (exploration),
+// the others bred from the parents_ (indices of good candidates), 3 in 5 by
+// mutation, 2 in 5 by crossover...
+
+template<typename T>
+candidate<T> breed ( const population<T> & population_, const std::vector<std::size_t> & parents_ ) {
+
+	candidate<T> child;
+
+	const std::uint32_t r = getRandomBelow ( 10 );
+
+	if ( r < 5 or parents_.empty ( ) ) {
+
+		return child;
+	}
+
+	const candidate<T> a = population_.get ( parents_ [ getRandomBelow ( std::uint32_t ( parents_.size ( ) ) ) ] );
+
+	child.value = a.value;
+	child.value2 = a.value2;
+	child.variant = a.variant;
+
+	if ( r < 8 ) {
+
+		switch ( g_search_mixer_family ? getRandomBelow ( 3 ) : 0 ) {
+
+			case 0: child.value = mutate ( a.value ); break;
+			case 1: child.value2 = mutate ( a.value2 ); break;
+			default: child.variant = mutateVariant<T> ( a.variant ); break;
+		}
+	}
+
+	else {
+
+		const candidate<T> b = population_.get ( parents_ [ getRandomBelow ( std::uint32_t ( parents_.size ( ) ) ) ] );
+
+		child.value = crossover ( a.value, b.value );
+		child.value2 = crossover ( a.value2, b.value2 );
+		child.variant = getRandomBelow ( 2 ) ? a.variant : b.variant;
+	}
+
+	if ( not g_search_mixer_family ) {
+
+		child.value2 = child.value;
+	}
+
+	if ( not passesPrefilter ( child.value ) or ( child.value2 != child.value and not passesPrefilter ( child.value2 ) ) ) {
+
+		return candidate<T> ( );
+	}
+
+	child.recall ( );
+
+	return child;
+}
+
+// The score database is to keep every candidate scored, not just the ones
+// in the population at a checkpoint: the ones replaced in between and the
+// neighbours hill climbing tried go in too...
+
+template<typename T>
+void storeScore ( const candidate<T> & c_ ) {
+
+	if ( exactScoring ( ) and scoreDb<T> ( ).is_open ( ) ) {
+
+		scoreDb<T> ( ).store ( c_.record ( ) );
+	}
+}
+
+
+// Hill climbing: all single bit flip neighbours of each of the parents_, but
+// those already in the population, are evaluated twice, the best neighbour
+// of each parent, if it beats the parent, takes the place of the weakest of
+// the candidates at indices_. The best of (up to) 63 two-evaluation scores
+// is biased low (the winner's curse), so it's raced against its parent
+// first, evaluated until the bounds of the two come apart or it has as many
+// evaluations as the parent. Returns the number of
+// evaluate ( ) calls spent...
+
+template<typename T>
+std::size_t climb ( population<T> & population_, const std::vector<std::size_t> & parents_, std::vector<std::size_t> & indices_ ) {
+
+	constexpr std::uint32_t neighbours = sizeof ( T ) * 8 - 1;
+
+	population<T> trials;
+	std::vector<std::size_t> first { 0 }; // the neighbours of parent p are trials first [ p ] to first [ p + 1 ]
+
+	trials.reserve ( parents_.size ( ) * neighbours );
+
+	candidate_keys<T> taken = getCandidateKeys ( population_ );
+
+	for ( const std::size_t p : parents_ ) {
+
+		const telemetry_scope scope ( telemetry_phase::replacement );
+
+		for ( std::uint32_t b = 1; b <= neighbours; ++b ) {
+
+			candidate<T> c = population_.get ( p );
+
+			c.value = flipBit ( c.value, b );
+			c.value2 = g_search_mixer_family ? c.value2 : c.value;
+
+			if ( not taken.insert ( { c.value, c.value2, c.variant } ).second ) {
+
+				continue;
+			}
+
+			c.evaluations = c.ctr = 0;
+			c.score = c.m2 = 0.0;
+			c.histogram.clear ( );
+			c.recall ( );
+
+			trials.push_back ( c );
+		}
+
+		first.push_back ( trials.size ( ) );
+	}
+
+	std::size_t spent = 0;
+
+	for ( std::size_t i = 0; i < trials.size ( ); ++i ) {
+
+		spent += 2 - std::min<std::size_t> ( 2, trials.ctr ( i ) );
+	}
+
+	for ( std::size_t round = 0; round < 2; ++round ) {
+
+		std::vector<std::size_t> fresh;
+
+		for ( std::size_t i = 0; i < trials.size ( ); ++i ) {
+
+			if ( trials.ctr ( i ) < 2 ) {
+
+				fresh.push_back ( i );
+			}
+		}
+
+		evaluateAll ( trials, fresh );
+	}
+
+	// Only the weakest few are needed, weakest first...
+
+	const std::size_t weakest = std::min ( parents_.size ( ), indices_.size ( ) );
+	const auto by_lower = [ & ] ( const std::size_t a_, const std::size_t b_ ) { return population_.lower ( a_, race_z ) > population_.lower ( b_, race_z ); };
+
+	{
+		const telemetry_scope scope ( telemetry_phase::selection );
+
+		std::partial_sort ( std::begin ( indices_ ), std::begin ( indices_ ) + weakest, std::end ( indices_ ), by_lower );
+	}
+
+	std::vector<std::size_t> winners ( parents_.size ( ), trials.size ( ) ); // trials.size ( ): no neighbour left
+
+	for ( std::size_t p = 0; p < parents_.size ( ); ++p ) {
+
+		for ( std::size_t i = first [ p ]; i < first [ p + 1 ]; ++i ) {
+
+			winners [ p ] = winners [ p ] == trials.size ( ) or trials.score ( i ) < trials.score ( winners [ p ] ) ? i : winners [ p ];
+		}
+	}
+
+	const auto undecided = [ & ] ( const std::size_t p_ ) {
+
+		const std::size_t w = winners [ p_ ], q = parents_ [ p_ ];
+
+		return w < trials.size ( ) and trials.ctr ( w ) < population_.ctr ( q ) and trials.upper ( w, race_z ) >= population_.lower ( q, race_z ) and trials.lower ( w, race_z ) <= population_.upper ( q, race_z );
+	};
+
+	for ( std::vector<std::size_t> pending; ; ) {
+
+		pending.clear ( );
+
+		for ( std::size_t p = 0; p < parents_.size ( ); ++p ) {
+
+			if ( undecided ( p ) ) {
+
+				pending.push_back ( winners [ p ] );
+			}
+		}
+
+		if ( pending.empty ( ) ) {
+
+			break;
+		}
+
+		evaluateAll ( trials, pending );
+
+		spent += pending.size ( );
+	}
+
+	const telemetry_scope scope ( telemetry_phase::replacement );
+
+	for ( std::size_t i = 0; i < trials.size ( ); ++i ) {
+
+		storeScore ( trials.get ( i ) );
+	}
+
+	for ( std::size_t p = 0, w = 0; p < parents_.size ( ) and w < weakest; ++p ) {
+
+		if ( winners [ p ] < trials.size ( ) and trials.score ( winners [ p ] ) < population_.score ( parents_ [ p ] ) ) {
+
+			storeScore ( population_.get ( indices_ [ w ] ) );
+
+			population_.set ( indices_ [ w++ ], trials.get ( winners [ p ] ) );
+		}
+	}
+
+	return spent;
+}
+
+
+// Racing: one generation, spends about budget_ evaluate ( ) calls, more if
+// the replacements (or a fresh population) need their first two, returns
+// the number spent. The incumbent is the candidate with the lowest upper
+// confidence bound, every candidate whose lower bound lies above it is
+// hopeless and is replaced, by breed ( ), from the best contenders, a child
+// already in the population is redrawn. The best few are hill climbed.
+// What remains of the budget goes to the contenders, successive halving
+// style: all of them, then the most promising half (lowest lower bound),
+// then half of that, ... until the budget is spent...
+
+constexpr std::size_t race_parents = 64, climb_parents = 4;
+
+template<typename T>
+std::size_t race ( population<T> & population_, std::size_t budget_ ) {
+
+	std::size_t spent = 0;
+
+	const auto spend = [ & ] ( std::vector<std::size_t> & indices_ ) {
+
+		evaluateAll ( population_, indices_ );
+
+		budget_ -= std::min ( budget_, indices_.size ( ) );
+		spent += indices_.size ( );
+	};
+
+	// Everybody needs two evaluations for a variance, candidates recalled
+	// from the score database may have them already...
+
+	const auto initialize = [ & ] ( const std::vector<std::size_t> & indices_ ) {
+
+		std::vector<std::size_t> fresh;
+
+		for ( std::size_t round = 0; round < 2; ++round ) {
+
+			fresh.clear ( );
+
+			for ( const std::size_t i : indices_ ) {
+
+				if ( population_.ctr ( i ) < 2 ) {
+
+					fresh.push_back ( i );
+				}
+			}
+
+			spend ( fresh );
+		}
+	};
+
+	std::vector<std::size_t> indices ( population_.size ( ) );
+
+	std::iota ( std::begin ( indices ), std::end ( indices ), std::size_t ( 0 ) );
+
+	initialize ( indices );
+
+	std::vector<std::size_t> contenders, parents;
+
+	{
+		const telemetry_scope scope ( telemetry_phase::selection );
+
+		double incumbent = population_.upper ( 0, race_z );
+
+		for ( std::size_t i = 1; i < population_.size ( ); ++i ) {
+
+			incumbent = std::min ( incumbent, population_.upper ( i, race_z ) );
+		}
+
+		indices.clear ( );
+
+		for ( std::size_t i = 0; i < population_.size ( ); ++i ) {
+
+			( population_.lower ( i, race_z ) > incumbent ? indices : contenders ).push_back ( i );
+		}
+
+		parents = contenders;
+
+		const auto by_score = [ & ] ( const std::size_t a_, const std::size_t b_ ) { return population_.score ( a_ ) < population_.score ( b_ ); };
+
+		if ( parents.size ( ) > race_parents ) {
+
+			std::nth_element ( std::begin ( parents ), std::begin ( parents ) + race_parents, std::end ( parents ), by_score );
+			parents.resize ( race_parents );
+		}
+
+		std::sort ( std::begin ( parents ), std::end ( parents ), by_score );
+	}
+
+	{
+		const telemetry_scope scope ( telemetry_phase::replacement );
+
+		candidate_keys<T> taken = getCandidateKeys ( population_ );
+
+		for ( const std::size_t i : indices ) {
+
+			candidate<T> child = breed ( population_, parents );
+
+			for ( std::uint32_t r = 0; r < max_redraws and not taken.insert ( { child.value, child.value2, child.variant } ).second; ++r ) {
+
+				child = breed ( population_, parents );
+			}
+
+			storeScore ( population_.get ( i ) );
+
+			population_.set ( i, child );
+		}
+	}
+
+	initialize ( indices );
+
+	parents.resize ( std::min ( parents.size ( ), climb_parents ) );
+
+	const std::size_t climbed = climb ( population_, parents, contenders );
+
+	budget_ -= std::min ( budget_, climbed );
+	spent += climbed;
+
+	// Every round the most promising part, on the bounds as they are then,
+	// by partial selection: O ( n ) a round, and the rounds halve...
+
+	const auto by_lower = [ & ] ( const std::size_t a_, const std::size_t b_ ) { return population_.lower ( a_, race_z ) < population_.lower ( b_, race_z ); };
+
+	for ( std::size_t n = contenders.size ( ); budget_ and n; n = ( n + 1 ) / 2 ) {
+
+		n = std::min ( n, budget_ );
+
+		if ( n < contenders.size ( ) ) {
+
+			const telemetry_scope scope ( telemetry_phase::selection );
+
+			std::nth_element ( std::begin ( contenders ), std::begin ( contenders ) + n, std::end ( contenders ), by_lower );
+			contenders.resize ( n );
+		}
+
+		spend ( contenders );
+	}
+
+	return spent;
+}
+
+// The best constants found so far, see the bottom of this file...
+
+constexpr std::uint64_t known_good_multipliers [ ] {
+
+	0x0CF3FD1B9997F637, 0xDBBF59B09980D163, 0x1AEC805299990163, 0x329FF22C54C063B9, 0xB25880B9598CFE8D,
+	2064167726340199425ULL, 14831393149721859073ULL, 10064833879070834689ULL, 15270417933577923073ULL, 16003472649440565889ULL, 6783152649535924737ULL,
+	15902845056476064385ULL, 6699509707676226881ULL, 18410416285450594625ULL, 14049795677467858241ULL, 5553275399470672577ULL, 12673909164712089953ULL,
+	5895393256363349695ULL, 12077015678325397305ULL, 5420600479766853331ULL, 7477738296582267083ULL, 18430510334115963153ULL
+};
+
+template<typename T>
+checkpoint<T> makeCheckpoint ( const population<T> & population_, const std::uint64_t generation_ ) {
+
+	checkpoint<T> c;
+
+	c.generation = generation_;
+
+	{
+		std::lock_guard<std::mutex> lock ( g_rng_master_mutex );
+
+		g_rng_master.getState ( c.rng [ 0 ], c.rng [ 1 ] );
+	}
+
+	c.records.reserve ( population_.size ( ) );
+
+	for ( std::size_t i = 0; i < population_.size ( ); ++i ) {
+
+		const candidate<T> p = population_.get ( i );
+
+		c.records.push_back ( { p.value, p.value2, p.variant, p.evaluations, p.ctr, p.score, p.m2, { } } );
+
+		std::copy ( p.histogram.bins ( ), p.histogram.bins ( ) + popcount_histogram<T>::size, c.records.back ( ).histogram );
+	}
+
+	return c;
+}
+
+// Resumes from the checkpoint if there is one, otherwise starts a fresh
+// population, optionally seeded with the known good multipliers. Returns
+// the generation to continue from...
+
+template<typename T>
+std::uint64_t restorePopulation ( population<T> & population_, const std::string & path_, const bool seed_known_good_ ) {
+
+	checkpoint<T> c;
+
+	if ( loadCheckpoint ( path_, c ) ) {
+
+		{
+			std::lock_guard<std::mutex> lock ( g_rng_master_mutex );
+
+			g_rng_master.setState ( c.rng [ 0 ], c.rng [ 1 ] );
+		}
+
+		for ( std::size_t i = 0; i < std::min ( population_.size ( ), c.records.size ( ) ); ++i ) {
+
+			candidate<T> p = population_.get ( i );
+			const auto & r = c.records [ i ];
+
+			p.value = r.value;
+			p.value2 = r.value2;
+			p.variant = std::uint32_t ( r.variant );
+			p.evaluations = r.evaluations;
+			p.ctr = r.ctr;
+			p.score = r.score;
+			p.m2 = r.m2;
+
+			std::copy ( r.histogram, r.histogram + popcount_histogram<T>::size, p.histogram.bins ( ) );
+
+			population_.set ( i, p );
+		}
+
+		std::cout << "resumed " << c.records.size ( ) << " candidates at generation " << c.generation << " from " << path_ << std::endl;
+
+		return c.generation;
+	}
+
+	if ( seed_known_good_ ) {
+
+		for ( std::size_t i = 0; i < std::min ( population_.size ( ), std::size ( known_good_multipliers ) ); ++i ) {
+
+			population_.set ( i, candidate<T> ( T ( known_good_multipliers [ i ] ), T ( known_good_multipliers [ i ] ), mixer_family<T>::classic ( ), population_.eval_unit ( ) ) );
+		}
+	}
+
+	for ( std::size_t i = 0; i < population_.size ( ); ++i ) {
+
+		candidate<T> p = population_.get ( i );
+
+		p.recall ( );
+
+		population_.set ( i, p );
+	}
+
+	return 0;
+}
+
+// The distribution and collision test battery, over the hashes of n_ keys
+// from each distribution in the key mix. batch_ ( x, y, n ) hashes n keys;
+// the hashing runs on the worker pool...
+
+template<typename T, typename B>
+std::vector<inthashing::battery_result> getBattery ( const B & batch_, const std::size_t n_ ) {
+
+	std::vector<T> keys ( n_ ), h ( n_ );
+	std::vector<inthashing::battery_result> results;
+
+	for ( const key_distribution d : g_key_mix ) {
+
+		for ( std::size_t i = 0; i < n_; i += key_batch_size ) {
+
+			const std::size_t n = std::min ( key_batch_size, n_ - i );
+			const T * k = getKeys ( d, keys.data ( ) + i, n );
+
+			if ( k != keys.data ( ) + i ) {
+
+				std::copy ( k, k + n, keys.data ( ) + i );
+			}
+		}
+
+		workers ( ).parallel_for ( ( n_ + key_batch_size - 1 ) / key_batch_size, [ & ] ( const std::size_t c_ ) {
+
+			const std::size_t b = c_ * key_batch_size;
+
+			batch_ ( keys.data ( ) + b, h.data ( ) + b, std::min ( key_batch_size, n_ - b ) );
+		}, 4 );
+
+		const std::vector<inthashing::battery_result> r = inthashing::runBattery ( h.data ( ), n_ );
+
+		results.insert ( std::end ( results ), std::begin ( r ), std::end ( r ) );
+	}
+
+	return results;
+}
+
+template<typename T>
+std::vector<inthashing::battery_result> getBattery ( const candidate<T> & c_, const std::size_t n_ ) {
+
+	const typename mixer_family<T>::hash_function hash = mixer_family<T>::hashes [ c_.variant ];
+
+	return getBattery<T> ( [ & ] ( const T * x_, T * y_, const std::size_t k_ ) { hash ( c_.value, c_.value2, x_, y_, k_ ); }, n_ );
+}
+
+// The differentials of a candidate of any variant, through the hash
+// table, to find its worst input difference...
+
+template<typename T>
+differential_result getDifferentialMSR ( const candidate<T> & c_, const std::size_t i_ ) {
+
+	const typename mixer_family<T>::hash_function hash = mixer_family<T>::hashes [ c_.variant ];
+
+	return getDifferentialMSR<T> ( [ & ] ( const T * x_, T * y_, const std::size_t n_ ) { hash ( c_.value, c_.value2, x_, y_, n_ ); }, i_ );
+}
+
+void printBattery ( const std::vector<inthashing::battery_result> & results_ ) {
+
+	const std::size_t per_distribution = results_.size ( ) / std::max<std::size_t> ( 1, g_key_mix.size ( ) );
+
+	for ( std::size_t i = 0; i < results_.size ( ); ++i ) {
+
+		const inthashing::battery_result & r = results_ [ i ];
+
+		printf ( "  %-8s %-16s %10llu %16.2f %16.2f %8.2f%s\n", keyDistributionName ( g_key_mix [ i / per_distribution ] ), r.name, ( unsigned long long ) r.parameter, r.statistic, r.expected, r.z, std::abs ( r.z ) < inthashing::battery_threshold ? "" : " FAIL" );
+	}
+}
+
+
+// Standalone: the battery, and the raw hashing throughput, for
+// inthashing::hash and jimi::hash, unkeyed and keyed, the latency of the
+// two jimi::hash ( )'s...
+
+int mainBattery ( ) {
+
+	constexpr std::size_t n = std::size_t ( 1 ) << 24;
+	constexpr std::uint64_t m = 0x0CF3FD1B9997F637;
+
+	const auto bench = [ ] ( const char * name_, const auto & hash_ ) {
+
+		std::vector<std::uint64_t> keys ( n ), h ( n );
+
+		std::iota ( std::begin ( keys ), std::end ( keys ), getRandom<std::uint64_t> ( ) );
+
+		const auto start = std::chrono::steady_clock::now ( );
+
+		inthashing::hashKeys ( hash_, keys.data ( ), h.data ( ), n );
+
+		const double seconds = std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( );
+
+		printf ( "%s: %.2f GB/s, %.2f Gkeys/s\n", name_, double ( 2 * n * sizeof ( std::uint64_t ) ) / seconds * 1e-9, double ( n ) / seconds * 1e-9 );
+
+		const auto results = getBattery<std::uint64_t> ( [ & ] ( const std::uint64_t * x_, std::uint64_t * y_, const std::size_t n_ ) {
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				y_ [ i ] = hash_ ( x_ [ i ] );
+			}
+		}, n );
+
+		printBattery ( results );
+
+		printf ( "%s: %s, worst |z| %.2f\n\n", name_, inthashing::batteryPasses ( results ) ? "pass" : "fail", inthashing::worstZ ( results ) );
+	};
+
+	bench ( "inthashing::hash", [ ] ( const std::uint64_t x_ ) { return inthashing::hash ( x_, m ); } );
+	bench ( "jimi::hash", [ ] ( const std::uint64_t x_ ) { return jimi::hash ( x_ ); } );
+
+	std::uint64_t key;
+
+	jimi::seed ( key );
+
+	bench ( "jimi::hash, keyed", [ key ] ( const std::uint64_t x_ ) { return jimi::hash ( x_, key ); } );
+
+	// Latency, a chain of n dependent hashes, the keyed one is one add
+	// longer...
+
+	{
+		const auto chain = [ ] ( const char * name_, const auto & hash_ ) {
+
+			std::uint64_t x = getRandom<std::uint64_t> ( );
+
+			const auto start = std::chrono::steady_clock::now ( );
+
+			for ( std::size_t i = 0; i < n; ++i ) {
+
+				x = hash_ ( x );
+			}
+
+			const double seconds = std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( );
+
+			printf ( "%s, latency: %.2f ns per hash (%016llx)\n", name_, seconds / double ( n ) * 1e9, ( unsigned long long ) x );
+		};
+
+		chain ( "jimi::hash", [ ] ( const std::uint64_t x_ ) { return jimi::hash ( x_ ); } );
+		chain ( "jimi::hash, keyed", [ key ] ( const std::uint64_t x_ ) { return jimi::hash ( x_, key ); } );
+	}
+
+	// The bulk jimi::hash, over the same number of keys...
+
+	{
+		std::vector<std::uint64_t> keys ( n ), h ( n );
+
+		std::iota ( std::begin ( keys ), std::end ( keys ), getRandom<std::uint64_t> ( ) );
+
+		const auto start = std::chrono::steady_clock::now ( );
+
+		jimi::hash ( keys.data ( ), h.data ( ), n );
+
+		const double seconds = std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( );
+
+		printf ( "jimi::hash, bulk, %s: %.2f GB/s, %.2f Gkeys/s\n", jimi::hashKernelName ( ), double ( 2 * n * sizeof ( std::uint64_t ) ) / seconds * 1e-9, double ( n ) / seconds * 1e-9 );
+	}
+
+	return 0;
+}
+
+// The best n_ multipliers of the score database, by Ksac MSR, of those
+// with at least min_samples_ samples...
+
+template<typename T>
+void printTopScores ( const score_db<T> & db_, const std::size_t n_, const std::uint64_t min_samples_ ) {
+
+	std::vector<std::pair<double, const score_db_record<T> *>> top;
+
+	for ( const auto & e : db_ ) {
+
+		popcount_histogram<T> h;
+
+		std::copy ( e.second.histogram, e.second.histogram + popcount_histogram<T>::size, h.bins ( ) );
+
+		if ( h.samples ( ) >= min_samples_ ) {
+
+			top.emplace_back ( h.msr ( ), & e.second );
+		}
+	}
+
+	const std::size_t n = std::min ( n_, top.size ( ) );
+
+	std::partial_sort ( std::begin ( top ), std::begin ( top ) + n, std::end ( top ), [ ] ( const auto & a_, const auto & b_ ) { return a_.first < b_.first; } );
+
+	for ( std::size_t i = 0; i < n; ++i ) {
+
+		const score_db_record<T> & r = *top [ i ].second;
+
+		printf ( " %4zu - %s %s - %.10f - %20llu\n", i + 1, hexString ( r.value ).c_str ( ), hexString ( r.inverse ).c_str ( ), top [ i ].first, ( unsigned long long ) r.evaluations );
+
+		if ( r.variant != mixer_family<T>::classic ( ) or r.value2 != r.value ) {
+
+			printf ( "        %s %s - %u rounds, shifts %u %u %u\n", hexString ( r.value2 ).c_str ( ), hexString ( r.inverse2 ).c_str ( ), mixer_family<T>::rounds ( r.variant ), mixer_family<T>::shift1 ( r.variant ), mixer_family<T>::shift2 ( r.variant ), mixer_family<T>::shift3 ( r.variant ) );
+		}
+
+		// As a hash / unhash pair, see mixer_composition.hpp...
+
+		printf ( "        inthashing::xorshift_multiply<%s, %u, %u, %u, %s, %s, %u>\n", typeName<T> ( ).c_str ( ), mixer_family<T>::shift1 ( r.variant ), mixer_family<T>::shift2 ( r.variant ), mixer_family<T>::shift3 ( r.variant ), literalString ( r.value ).c_str ( ), literalString ( r.value2 ).c_str ( ), mixer_family<T>::rounds ( r.variant ) );
+	}
+}
+
+// Fits the prefilter to the score database: the region spanned by the best
+// fraction_ of the multipliers with at least min_samples_ samples, so that
+// nothing that looks like what scored well is rejected. False (and nothing
+// learned) with fewer than min_records_ of those...
+
+template<typename T>
+bool learnPrefilter ( const score_db<T> & db_, inthashing::prefilter_thresholds & thresholds_, const double fraction_ = 0.1, const std::uint64_t min_samples_ = 100'000, const std::size_t min_records_ = 1'000 ) {
+
+	std::vector<std::pair<double, const score_db_record<T> *>> scored;
+
+	for ( const auto & e : db_ ) {
+
+		popcount_histogram<T> h;
+
+		std::copy ( e.second.histogram, e.second.histogram + popcount_histogram<T>::size, h.bins ( ) );
+
+		if ( h.samples ( ) >= min_samples_ ) {
+
+			scored.emplace_back ( h.msr ( ), & e.second );
+		}
+	}
+
+	if ( scored.size ( ) < min_records_ ) {
+
+		return false;
+	}
+
+	const std::size_t n = std::max<std::size_t> ( 1, std::size_t ( double ( scored.size ( ) ) * fraction_ ) );
+
+	std::nth_element ( std::begin ( scored ), std::begin ( scored ) + ( n - 1 ), std::end ( scored ), [ ] ( const auto & a_, const auto & b_ ) { return a_.first < b_.first; } );
+
+	thresholds_ = inthashing::emptyPrefilter<T> ( );
+
+	for ( std::size_t i = 0; i < n; ++i ) {
+
+		thresholds_.include ( inthashing::getMultiplierFeatures ( scored [ i ].second->value ) );
+		thresholds_.include ( inthashing::getMultiplierFeatures ( scored [ i ].second->value2 ) );
+	}
+
+	return true;
+}
+
+template<typename T>
+int mainTopScores ( const std::string & path_ ) {
+
+	score_db<T> db;
+
+	if ( not db.open ( path_ ) ) {
+
+		std::cerr << path_ << " is not a " << sizeof ( T ) * 8 << "-bit score database" << std::endl;
+
+		return 1;
+	}
+
+	std::cout << db.size ( ) << " multipliers" << std::endl;
+
+	printTopScores ( db, 20, 1'000'000 );
+
+	return 0;
+}
+
+
+// The command line, see usage ( )...
+
+struct search_options {
+
+	std::string command = "search";
+	std::uint32_t width = 64;
+	bool family = false, seed_known_good = true, battery_filter = false;
+	std::size_t population = 16 * 1'024, threads = std::thread::hardware_concurrency ( ), eval_unit = 6 * 1'024;
+	double seconds = 0.0; // wall clock budget, 0 is none
+	std::uint64_t evaluations = 0; // evaluate ( ) budget, 0 is none
+	std::uint64_t multiplier = 0; // verify: the classic mixer with this multiplier, 0 is jimi::hash
+	std::string output = "inthashing", keys; // output.ckpt and output.scores, the replay keys
+	std::string shortlist; // exhaustive: a file of multipliers, one a line (0x... for hex)
+};
+
+void usage ( ) {
+
+	std::cerr <<
+		"usage: inthashing [search | watch | top | battery | exhaustive | random | verify] [options]\n"
+		"\n"
+		"  search       the population search (default), checkpointed, resumes\n"
+		"  watch        the live telemetry of the search with the same --output\n"
+		"  top          the best multipliers of the score database\n"
+		"  battery      the test battery, throughput and latency of the 64-bit hashes\n"
+		"  exhaustive   the best multiplier over all inputs, of all of them at 8 or\n"
+		"               16 bits, of --multiplier and --shortlist up to 32 bits\n"
+		"  random       random restarts, no population\n"
+		"  verify       hash and unhash are inverse permutations, over every input\n"
+		"               up to 32 bits, jimi::hash (32 bits, also keyed, or 128 bits)\n"
+		"               or the classic mixer of --multiplier\n"
+		"\n"
+		"  --width n         8, 16, 32, 64 or 128 bits (64)\n"
+		"  --family          also search shifts, rounds and a second multiplier\n"
+		"  --population n    candidates (16384)\n"
+		"  --threads n       worker threads (all)\n"
+		"  --eval-unit n     Ksac samples per evaluation (6144)\n"
+		"  --seconds s       stop after s seconds of wall clock\n"
+		"  --evaluations n   stop after about n evaluations\n"
+		"  --output path     path.ckpt and path.scores (inthashing)\n"
+		"  --keys path       score on these keys (native endian) as well\n"
+		"  --no-seed         don't seed with the known good multipliers\n"
+		"  --battery-filter  a best candidate failing the test battery is demoted\n"
+		"                    (scored the worst) before it's reported or checkpointed\n"
+		"  --multiplier m    verify (or exhaustive) the classic mixer of m (0x... for hex)\n"
+		"  --shortlist path  exhaustive: the multipliers in path, one a line\n";
+}
+
+// False on anything it doesn't understand...
+
+bool parseOptions ( const int argc_, char ** argv_, search_options & options_ ) {
+
+	int i = 1;
+
+	if ( i < argc_ and argv_ [ i ] [ 0 ] != '-' ) {
+
+		options_.command = argv_ [ i++ ];
+	}
+
+	try {
+
+		for ( ; i < argc_; ++i ) {
+
+			const std::string option = argv_ [ i ];
+
+			const auto value = [ & ] ( ) -> std::string {
+
+				if ( i + 1 == argc_ ) {
+
+					throw std::invalid_argument ( option );
+				}
+
+				return argv_ [ ++i ];
+			};
+
+			if ( option == "--width" ) options_.width = std::uint32_t ( std::stoul ( value ( ) ) );
+			else if ( option == "--family" ) options_.family = true;
+			else if ( option == "--population" ) options_.population = std::stoull ( value ( ) );
+			else if ( option == "--threads" ) options_.threads = std::stoull ( value ( ) );
+			else if ( option == "--eval-unit" ) options_.eval_unit = std::stoull ( value ( ) );
+			else if ( option == "--seconds" ) options_.seconds = std::stod ( value ( ) );
+			else if ( option == "--evaluations" ) options_.evaluations = std::stoull ( value ( ) );
+			else if ( option == "--output" ) options_.output = value ( );
+			else if ( option == "--keys" ) options_.keys = value ( );
+			else if ( option == "--multiplier" ) options_.multiplier = std::stoull ( value ( ), nullptr, 0 );
+			else if ( option == "--shortlist" ) options_.shortlist = value ( );
+			else if ( option == "--no-seed" ) options_.seed_known_good = false;
+			else if ( option == "--battery-filter" ) options_.battery_filter = true;
+			else return false;
+		}
+	}
+
+	catch ( const std::exception & ) {
+
+		return false;
+	}
+
+	return options_.population > 1 and options_.eval_unit > 0;
+}
+
+// The multipliers for exhaustive: --multiplier, then those of the
+// --shortlist file. False if the file can't be read or parsed...
+
+bool getShortlist ( const search_options & options_, std::vector<std::uint64_t> & shortlist_ ) {
+
+	if ( options_.multiplier ) {
+
+		shortlist_.push_back ( options_.multiplier );
+	}
+
+	if ( options_.shortlist.empty ( ) ) {
+
+		return true;
+	}
+
+	std::ifstream file ( options_.shortlist );
+
+	if ( not file ) {
+
+		std::cerr << "exhaustive: can not read " << options_.shortlist << std::endl;
+
+		return false;
+	}
+
+	try {
+
+		for ( std::string m; file >> m; ) {
+
+			shortlist_.push_back ( std::stoull ( m, nullptr, 0 ) );
+		}
+	}
+
+	catch ( const std::exception & ) {
+
+		std::cerr << "exhaustive: " << options_.shortlist << " is not a list of multipliers" << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+// The name of the telemetry segment of the search with output path_...
+
+std::string telemetryName ( const std::string & path_ ) {
+
+	std::string name { "inthashing.telemetry." };
+
+	for ( const char c : path_ ) {
+
+		name += c == '/' or c == '\\' or c == ':' ? '_' : c;
+	}
+
+	return name;
+}
+
+// Calls f_ with a value of the unsigned type of width_ bits, every width
+// is its own instantiation of everything under f_, compiled ahead of time,
+// the widths and shifts stay constants in the hot loops...
+
+template<typename F>
+int dispatchWidth ( const std::uint32_t width_, const F & f_ ) {
+
+	switch ( width_ ) {
+
+		case 8: return f_ ( std::uint8_t ( 0 ) );
+		case 16: return f_ ( std::uint16_t ( 0 ) );
+		case 32: return f_ ( std::uint32_t ( 0 ) );
+		case 64: return f_ ( std::uint64_t ( 0 ) );
+#ifdef JIMI_HAS_UINT128
+		case 128: return f_ ( jimi::uint128_t ( 0 ) );
+#endif
+	}
+
+#ifdef JIMI_HAS_UINT128
+	std::cerr << "no " << width_ << "-bit search, the widths are 8, 16, 32, 64 and 128" << std::endl;
+#else
+	std::cerr << "no " << width_ << "-bit search, the widths are 8, 16, 32 and 64 (128 needs a compiler with __int128)" << std::endl;
+#endif
+
+	return 1;
+}
+
+
+// The population search, until the budget (if any) is spent. It resumes
+// from, and checkpoints to, output.ckpt, every multiplier scored on the
+// plain Ksac MSR goes to output.scores, see storeScore ( )...
+
+template<typename T>
+int mainSearch ( const search_options & options_ ) {
+
+	const char format_string [ ] { " %10u - %s %s - %.10f - %20llu\n" };
+	const char family_format_string [ ] { "              %s %s - %u rounds, shifts %u %u %u\n" };
+
+	const std::size_t pop_size = options_.population, generation_budget = pop_size + pop_size * 2 / 5; // what evaluating all and replacing 40% used to cost
+
+	const std::string checkpoint_path { options_.output + ".ckpt" };
+	constexpr std::uint32_t checkpoint_interval = 16; // generations
+	const bool seed_known_good = options_.seed_known_good and sizeof ( T ) == sizeof ( std::uint64_t ); // the known good are 64-bit
+	constexpr std::size_t battery_keys = std::size_t ( 1 ) << 20; // per distribution, the top candidates are re-tested every checkpoint
+	constexpr std::size_t differential_samples = std::size_t ( 1 ) << 20;
+
+	g_search_mixer_family = options_.family; // true: also search shifts, rounds and a second multiplier
+
+	g_score_kind = score_kind::ksac_msr;
+	g_bic_weight = 0.0; // > 0: add the bit independence criterion as a term
+	g_common_random_numbers = true; // candidates of a variant share their inputs, in blocks
+	g_eval_unit = options_.eval_unit;
+
+	g_key_mix = { key_distribution::uniform, key_distribution::counter }; // add strided, sparse, gray to score on those inputs too
+
+	if ( options_.keys.size ( ) ) {
+
+		g_key_mix.push_back ( key_distribution::replay );
+		g_key_replay_path = options_.keys; // native endian keys
+	}
+
+	checkpoint_writer<T> writer ( checkpoint_path );
+
+	const std::string score_db_path { options_.output + ".scores" }; // every multiplier scored (exactly), across runs
+
+	if ( not scoreDb<T> ( ).open ( score_db_path ) ) {
+
+		std::cerr << score_db_path << " is not a " << sizeof ( T ) * 8 << "-bit score database, not used" << std::endl;
+	}
+
+	g_use_prefilter = true; // reject structurally weak multipliers before scoring them
+	g_prefilter = inthashing::defaultPrefilter<T> ( );
+
+	const bool learned = learnPrefilter ( scoreDb<T> ( ), g_prefilter );
+
+	printf ( "prefilter (%s): popcount %u-%u, runs <= %u, halves %u-%u, order >= 2^%u\n", learned ? "learned" : "default", g_prefilter.min_popcount, g_prefilter.max_popcount, g_prefilter.max_run, g_prefilter.min_half_popcount, g_prefilter.max_half_popcount, g_prefilter.min_order_log2 );
+
+	if ( not searchTelemetry ( ).open ( telemetryName ( options_.output ), sizeof ( T ) * 8 ) and INTHASHING_TELEMETRY ) {
+
+		std::cerr << "no telemetry, the shared memory segment " << telemetryName ( options_.output ) << " could not be created" << std::endl;
+	}
+
+	population<T> population ( pop_size );
+
+	const auto start = std::chrono::steady_clock::now ( );
+	std::uint64_t spent = 0;
+
+	const auto budgetLeft = [ & ] ( ) {
+
+		if ( options_.evaluations and spent >= options_.evaluations ) {
+
+			return false;
+		}
+
+		return options_.seconds <= 0.0 or std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( ) < options_.seconds;
+	};
+
+	std::uint32_t i = std::uint32_t ( restorePopulation ( population, checkpoint_path, seed_known_good ) );
+
+	// The battery as a final filter (--battery-filter): every candidate that
+	// makes the best 3 is tested, once, one that fails is demoted to the
+	// worst score, race ( ) replaces it as hopeless the next generation...
+
+	candidate_keys<T> passed, failed;
+
+	const auto filterBest = [ & ] ( ) {
+
+		for ( bool demoted = options_.battery_filter; demoted; ) {
+
+			demoted = false;
+
+			for ( const std::size_t p : population.best ( 3 ) ) {
+
+				candidate<T> c = population.get ( p );
+
+				const candidate_key<T> key { c.value, c.value2, c.variant };
+
+				if ( std::isinf ( c.score ) or passed.count ( key ) ) {
+
+					continue;
+				}
+
+				if ( not failed.count ( key ) and inthashing::batteryPasses ( getBattery ( c, battery_keys ) ) ) {
+
+					passed.insert ( key );
+
+					continue;
+				}
+
+				failed.insert ( key );
+
+				c.score = std::numeric_limits<double>::infinity ( );
+
+				population.set ( p, c );
+
+				demoted = true;
+			}
+		}
+	};
+
+	for ( bool more = true; more; ++i ) {
+
+		// What race ( ) spent, which is more than its budget when the
+		// replacements need their first two evaluations...
+
+		spent += race ( population, options_.evaluations ? std::min<std::uint64_t> ( generation_budget, options_.evaluations - spent ) : generation_budget );
+		more = budgetLeft ( );
+
+		filterBest ( );
+
+		std::vector<std::size_t> top;
+
+		{
+			const telemetry_scope scope ( telemetry_phase::selection );
+
+			top = population.best ( 3 );
+		}
+
+		searchTelemetry ( ).generation ( i, std::uint64_t ( population.value ( top [ 0 ] ) ), population.score ( top [ 0 ] ) ); // the low 64 bits at 128
+
+		for ( const std::size_t p : top ) {
+
+			const candidate<T> c = population.get ( p );
+
+			printf ( format_string, i, hexString ( c.value ).c_str ( ), hexString ( getInverse ( c.value ) ).c_str ( ), c.score, ( unsigned long long ) c.evaluations );
+
+			if ( c.variant != mixer_family<T>::classic ( ) or c.value2 != c.value ) {
+
+				printf ( family_format_string, hexString ( c.value2 ).c_str ( ), hexString ( getInverse ( c.value2 ) ).c_str ( ), mixer_family<T>::rounds ( c.variant ), mixer_family<T>::shift1 ( c.variant ), mixer_family<T>::shift2 ( c.variant ), mixer_family<T>::shift3 ( c.variant ) );
+			}
+		}
+
+		std::cout << std::endl;
+
+		// The last generation is always checkpointed...
+
+		if ( not ( ( i + 1 ) % checkpoint_interval ) or not more ) {
+
+			writer.submit ( makeCheckpoint ( population, i + 1 ) );
+
+			if ( exactScoring ( ) and scoreDb<T> ( ).is_open ( ) ) {
+
+				for ( std::size_t p = 0; p < population.size ( ); ++p ) {
+
+					storeScore ( population.get ( p ) );
+				}
+
+				scoreDb<T> ( ).flush ( );
+			}
+
+			if ( g_use_prefilter ) {
+
+				printf ( "              prefilter rejected %llu of %llu multipliers\n", ( unsigned long long ) g_prefilter_rejected.load ( ), ( unsigned long long ) g_prefilter_tested.load ( ) );
+			}
+
+			// SAC alone does not show a bad spread over the buckets...
+
+			for ( const std::size_t p : top ) {
+
+				const candidate<T> c = population.get ( p );
+				const auto results = getBattery ( c, battery_keys );
+
+				printf ( "              %s battery %s, worst |z| %.2f\n", hexString ( c.value ).c_str ( ), inthashing::batteryPasses ( results ) ? "pass" : "fail", inthashing::worstZ ( results ) );
+
+				const differential_result differential = getDifferentialMSR ( c, differential_samples );
+				const inthashing::input_difference<T> & worst = getDifferences<T> ( ) [ differential.worst_index ];
+
+				printf ( "              %s differentials %.10f, worst %.10f, %s %s\n", hexString ( c.value ).c_str ( ), differential.mean, differential.worst, inthashing::differenceKindName ( worst.kind ), hexString ( worst.value ).c_str ( ) );
+			}
+
+			std::cout << std::endl;
+		}
+	}
+
+	printf ( "spent %llu evaluations in %.0f seconds\n", ( unsigned long long ) spent, std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( ) );
+
+	searchTelemetry ( ).close ( );
+
+	return 0;
+}
+
+// The viewer: polls the telemetry of the search with the same output,
+// every interval_ seconds, until that search ends...
+
+int mainWatch ( const search_options & options_, const double interval_ = 2.0 ) {
+
+	telemetry_view view;
+
+	if ( not view.open ( telemetryName ( options_.output ) ) ) {
+
+		std::cerr << "no search running with output " << options_.output << std::endl;
+
+		return 1;
+	}
+
+	const telemetry_page & page = view.page ( );
+
+	constexpr std::uint32_t phases = std::uint32_t ( telemetry_phase::count );
+
+	std::vector<std::uint64_t> last ( telemetry_page::max_threads, 0 );
+	std::uint64_t last_ns [ phases ] = { }, seen = 0;
+
+	while ( page.running.load ( std::memory_order_acquire ) ) {
+
+		std::this_thread::sleep_for ( std::chrono::duration<double> ( interval_ ) );
+
+		const std::uint32_t threads = std::min ( page.threads.load ( std::memory_order_relaxed ), telemetry_page::max_threads );
+
+		std::uint64_t total = 0, ns [ phases ] = { }, ns_total = 0;
+
+		printf ( "%u-bit search, generation %llu\n  evaluations/s:", page.width, ( unsigned long long ) page.generation.load ( std::memory_order_relaxed ) );
+
+		for ( std::uint32_t t = 0; t < threads; ++t ) {
+
+			const std::uint64_t e = page.thread [ t ].evaluations.load ( std::memory_order_relaxed );
+
+			printf ( " %.0f", double ( e - last [ t ] ) / interval_ );
+
+			total += e - last [ t ];
+			last [ t ] = e;
+
+			for ( std::uint32_t p = 0; p < phases; ++p ) {
+
+				ns [ p ] += page.thread [ t ].nanoseconds [ p ].load ( std::memory_order_relaxed );
+			}
+		}
+
+		printf ( ", total %.0f\n ", double ( total ) / interval_ );
+
+		for ( std::uint32_t p = 0; p < phases; ++p ) {
+
+			ns_total += ns [ p ] - last_ns [ p ];
+		}
+
+		for ( std::uint32_t p = 0; p < phases; ++p ) {
+
+			printf ( " %s %.1f%%", telemetryPhaseName ( telemetry_phase ( p ) ), ns_total ? 100.0 * double ( ns [ p ] - last_ns [ p ] ) / double ( ns_total ) : 0.0 );
+
+			last_ns [ p ] = ns [ p ];
+		}
+
+		printf ( "\n" );
+
+		// The best scores since the last poll, what's left of them in the ring...
+
+		const std::uint64_t history = page.history.load ( std::memory_order_acquire );
+
+		for ( std::uint64_t h = std::max ( seen, history - std::min<std::uint64_t> ( history, telemetry_page::history_size ) ); h < history; ++h ) {
+
+			std::uint64_t generation, value;
+			double score;
+
+			if ( view.best ( h, generation, value, score ) ) {
+
+				printf ( "  %10llu - 0x%016llX - %.10f\n", ( unsigned long long ) generation, ( unsigned long long ) value, score );
+			}
+		}
+
+		seen = history;
+
+		std::cout << std::endl;
+	}
+
+	return 0;
+}
+
+// Certifies a hash / unhash pair: jimi::hash ( ) and jimi::unHash ( ),
+// 32-bit (every input) or 128-bit (random inputs), or the classic mixer of
+// the multiplier and of its inverse...
+
+template<typename T>
+int mainVerify ( const search_options & options_ ) {
+
+	const auto start = std::chrono::steady_clock::now ( );
+
+	if ( not options_.multiplier ) {
+
+		if constexpr ( sizeof ( T ) == 4 ) {
+
+			const inthashing::bijection_result r = inthashing::verifyBijection<std::uint32_t> (
+				[ ] ( const std::uint32_t * x_, std::uint32_t * y_, const std::size_t n_ ) { jimi::hash ( x_, y_, n_ ); },
+				[ ] ( const std::uint32_t * x_, std::uint32_t * y_, const std::size_t n_ ) { jimi::unHash ( x_, y_, n_ ); } );
+
+			printf ( "jimi::hash (%s): %s, %llu collisions, jimi::unHash: %s, %llu mismatches, %.1f seconds\n", jimi::hashKernelName ( ), r.permutation ? "permutation" : "NOT a permutation", ( unsigned long long ) r.collisions,
+				r.inverse ? "inverse" : "NOT the inverse", ( unsigned long long ) r.mismatches, std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( ) );
+
+			// And keyed, with a random key...
+
+			std::uint32_t key;
+
+			jimi::seed ( key );
+
+			const inthashing::bijection_result k = inthashing::verifyBijection<std::uint32_t> (
+				[ key ] ( const std::uint32_t * x_, std::uint32_t * y_, const std::size_t n_ ) { for ( std::size_t i = 0; i < n_; ++i ) y_ [ i ] = jimi::hash ( x_ [ i ], key ); },
+				[ key ] ( const std::uint32_t * x_, std::uint32_t * y_, const std::size_t n_ ) { for ( std::size_t i = 0; i < n_; ++i ) y_ [ i ] = jimi::unHash ( x_ [ i ], key ); } );
+
+			printf ( "jimi::hash, key 0x%08x: %s, %llu collisions, jimi::unHash: %s, %llu mismatches, %.1f seconds\n", key, k.permutation ? "permutation" : "NOT a permutation", ( unsigned long long ) k.collisions,
+				k.inverse ? "inverse" : "NOT the inverse", ( unsigned long long ) k.mismatches, std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( ) );
+
+			return r.permutation and r.inverse and k.permutation and k.inverse ? 0 : 1;
+		}
+
+#ifdef JIMI_HAS_UINT128
+		else if constexpr ( sizeof ( T ) == 16 ) {
+
+			const bool inverse = isInverse<T> (
+				[ ] ( const T * x_, T * y_, const std::size_t n_ ) { for ( std::size_t i = 0; i < n_; ++i ) y_ [ i ] = jimi::hash ( x_ [ i ] ); },
+				[ ] ( const T * x_, T * y_, const std::size_t n_ ) { for ( std::size_t i = 0; i < n_; ++i ) y_ [ i ] = jimi::unHash ( x_ [ i ] ); } );
+
+			printf ( "jimi::hash, jimi::unHash, 128-bit: %s, 2^30 random inputs, %.1f seconds\n", inverse ? "inverse" : "NOT inverse", std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( ) );
+
+			return inverse ? 0 : 1;
+		}
+#endif
+
+		std::cerr << "verify: jimi::hash is 32 or 128-bit, or give a --multiplier" << std::endl;
+
+		return 1;
+	}
+
+	const T m = T ( options_.multiplier );
+
+	if ( not ( m & 1 ) ) {
+
+		std::cerr << "verify: the multiplier must be odd" << std::endl;
+
+		return 1;
+	}
+
+	const bool inverse = isInverse ( m, getInverse ( m ) );
+
+	printf ( "%s %s: %s, %s, %.1f seconds\n", hexString ( m ).c_str ( ), hexString ( getInverse ( m ) ).c_str ( ), inverse ? "inverse permutations" : "NOT inverse permutations",
+		sizeof ( T ) <= 4 ? "every input" : "2^30 random inputs", std::chrono::duration<double> ( std::chrono::steady_clock::now ( ) - start ).count ( ) );
+
+	return inverse ? 0 : 1;
+}
+
+int32_t main ( int argc, char ** argv ) {
+
+	search_options options;
+
+	if ( not parseOptions ( argc, argv, options ) ) {
+
+		usage ( );
+
+		return 1;
+	}
+
+	g_worker_threads = options.threads;
+
+	if ( options.command == "search" ) {
+
+		return dispatchWidth ( options.width, [ & ] ( auto t_ ) { return mainSearch<decltype ( t_ )> ( options ); } );
+	}
+
+	if ( options.command == "top" ) {
+
+		return dispatchWidth ( options.width, [ & ] ( auto t_ ) { return mainTopScores<decltype ( t_ )> ( options.output + ".scores" ); } );
+	}
+
+	if ( options.command == "watch" ) {
+
+		return mainWatch ( options );
+	}
+
+	if ( options.command == "battery" ) {
+
+		return mainBattery ( );
+	}
+
+	if ( options.command == "exhaustive" ) {
+
+		std::vector<std::uint64_t> shortlist;
+
+		if ( not getShortlist ( options, shortlist ) ) {
+
+			return 1;
+		}
+
+		return dispatchWidth ( options.width, [ & ] ( auto t_ ) { return mainExhaustive<decltype ( t_ )> ( shortlist ); } );
+	}
+
+	if ( options.command == "verify" ) {
+
+		return dispatchWidth ( options.width, [ & ] ( auto t_ ) { return mainVerify<decltype ( t_ )> ( options ); } );
+	}
+
+	if ( options.command == "random" ) {
+
+		return dispatchWidth ( options.width, [ & ] ( auto t_ ) { return mainRandomSearch<decltype ( t_ )> ( ); } );
+	}
+
+	usage ( );
+
+	return 1;
 }
 
 
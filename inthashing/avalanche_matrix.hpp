@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+
+
+// Per input bit x per output bit flip counts, SMHasher style. Each sample
+// adds sizeof ( T ) * 8 output differences (one per flipped input bit) into
+// bit-sliced counters: plane p of row i holds bit p of the pending count of
+// every output bit of input bit i, so one carry-save add updates a whole
+// row. The loops run over the input bits innermost and vectorize. After 255
+// samples the planes are flushed into the plain counters...
+
+template<typename T>
+class avalanche_matrix {
+
+public:
+
+	static constexpr std::uint32_t bits = sizeof ( T ) * 8;
+
+private:
+
+	static constexpr std::uint32_t planes = 8, flush_interval = ( 1 << planes ) - 1;
+
+	T m_planes [ planes ] [ bits ] = { };
+	std::uint32_t m_pending = 0;
+
+	std::uint64_t m_counts [ bits ] [ bits ] = { };
+	std::uint64_t m_samples = 0;
+
+public:
+
+	// d_ [ i ] = hash ( x ) ^ hash ( x ^ ( 1 << i ) )...
+
+	void add ( const T * d_ ) noexcept {
+
+		T carry [ bits ];
+
+		std::copy ( d_, d_ + bits, carry );
+
+		for ( std::uint32_t p = 0; p < planes; ++p ) {
+
+			for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+				const T c = m_planes [ p ] [ i ] & carry [ i ];
+
+				m_planes [ p ] [ i ] ^= carry [ i ];
+				carry [ i ] = c;
+			}
+		}
+
+		if ( ++m_pending == flush_interval ) {
+
+			flush ( );
+		}
+	}
+
+	// Moves the pending plane counts into the counters, the readers below
+	// only see flushed samples...
+
+	void flush ( ) noexcept {
+
+		for ( std::uint32_t p = 0; p < planes; ++p ) {
+
+			for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+				for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+					m_counts [ i ] [ j ] += std::uint64_t ( ( m_planes [ p ] [ i ] >> j ) & T ( 1 ) ) << p;
+				}
+
+				m_planes [ p ] [ i ] = T ( 0 );
+			}
+		}
+
+		m_samples += m_pending;
+		m_pending = 0;
+	}
+
+	void merge ( avalanche_matrix & rhs_ ) noexcept {
+
+		flush ( );
+		rhs_.flush ( );
+
+		for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+			for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+				m_counts [ i ] [ j ] += rhs_.m_counts [ i ] [ j ];
+			}
+		}
+
+		m_samples += rhs_.m_samples;
+	}
+
+	std::uint64_t samples ( ) const noexcept {
+
+		return m_samples;
+	}
+
+	std::uint64_t count ( const std::uint32_t input_, const std::uint32_t output_ ) const noexcept {
+
+		return m_counts [ input_ ] [ output_ ];
+	}
+
+	// | 2 * P ( output bit j flips | input bit i flips ) - 1 |, 0 is ideal...
+
+	double bias ( const std::uint32_t input_, const std::uint32_t output_ ) const noexcept {
+
+		return std::abs ( 2.0 * double ( m_counts [ input_ ] [ output_ ] ) / double ( m_samples ) - 1.0 );
+	}
+
+	double max_bias ( ) const noexcept {
+
+		double max = 0.0;
+
+		for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+			for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+				max = std::max ( max, bias ( i, j ) );
+			}
+		}
+
+		return max;
+	}
+
+	double rms_bias ( ) const noexcept {
+
+		double sum = 0.0;
+
+		for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+			for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+				const double b = bias ( i, j );
+
+				sum += b * b;
+			}
+		}
+
+		return std::sqrt ( sum / double ( bits * bits ) );
+	}
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "sac_kernel.hpp"
+
+
+// Bit independence criterion: for every input bit i and every pair of output
+// bits j <= k, how often j and k flip together when i flips. The differences
+// of a block of samples are kept as they come, a row of them per sample, and
+// then transposed, 64 samples at a time, into columns: bit s of column j is
+// bit j of the difference of sample s. The count of ( i, j, k ) then grows by
+// popcount ( column j & column k ), one and and one popcount for 64 samples.
+// Everything is laid out with the input bit innermost, the vector lanes run
+// across the input bits, no loop has a tail. The diagonal, k == j, is the
+// plain flip count of j...
+
+namespace inthashing {
+
+	namespace detail {
+
+		// The lanes of the vector the bic_matrix loops run on...
+
+		struct bic_lanes {
+
+#if defined ( __AVX512DQ__ ) and defined ( __AVX512BW__ )
+
+			using type = __m512i;
+
+			static constexpr std::uint32_t size = 8;
+
+			static type load ( const std::uint64_t * p_ ) noexcept { return _mm512_loadu_si512 ( p_ ); }
+			static void store ( std::uint64_t * p_, const type x_ ) noexcept { _mm512_storeu_si512 ( p_, x_ ); }
+			static type zero ( ) noexcept { return _mm512_setzero_si512 ( ); }
+			static type broadcast ( const std::uint64_t x_ ) noexcept { return _mm512_set1_epi64 ( std::int64_t ( x_ ) ); }
+			static type and_ ( const type a_, const type b_ ) noexcept { return _mm512_and_si512 ( a_, b_ ); }
+			static type xor_ ( const type a_, const type b_ ) noexcept { return _mm512_xor_si512 ( a_, b_ ); }
+			static type add ( const type a_, const type b_ ) noexcept { return _mm512_add_epi64 ( a_, b_ ); }
+			static type shiftLeft ( const type x_, const std::uint32_t s_ ) noexcept { return _mm512_sll_epi64 ( x_, _mm_cvtsi32_si128 ( int ( s_ ) ) ); }
+			static type shiftRight ( const type x_, const std::uint32_t s_ ) noexcept { return _mm512_srl_epi64 ( x_, _mm_cvtsi32_si128 ( int ( s_ ) ) ); }
+			static type popcount ( const type x_ ) noexcept { return popcnt_epi64 ( x_ ); }
+
+#elif defined ( __AVX2__ )
+
+			using type = __m256i;
+
+			static constexpr std::uint32_t size = 4;
+
+			static type load ( const std::uint64_t * p_ ) noexcept { return _mm256_loadu_si256 ( ( const __m256i * ) p_ ); }
+			static void store ( std::uint64_t * p_, const type x_ ) noexcept { _mm256_storeu_si256 ( ( __m256i * ) p_, x_ ); }
+			static type zero ( ) noexcept { return _mm256_setzero_si256 ( ); }
+			static type broadcast ( const std::uint64_t x_ ) noexcept { return _mm256_set1_epi64x ( std::int64_t ( x_ ) ); }
+			static type and_ ( const type a_, const type b_ ) noexcept { return _mm256_and_si256 ( a_, b_ ); }
+			static type xor_ ( const type a_, const type b_ ) noexcept { return _mm256_xor_si256 ( a_, b_ ); }
+			static type add ( const type a_, const type b_ ) noexcept { return _mm256_add_epi64 ( a_, b_ ); }
+			static type shiftLeft ( const type x_, const std::uint32_t s_ ) noexcept { return _mm256_sll_epi64 ( x_, _mm_cvtsi32_si128 ( int ( s_ ) ) ); }
+			static type shiftRight ( const type x_, const std::uint32_t s_ ) noexcept { return _mm256_srl_epi64 ( x_, _mm_cvtsi32_si128 ( int ( s_ ) ) ); }
+			static type popcount ( const type x_ ) noexcept { return popcnt_epi64 ( x_ ); }
+
+#else
+
+			using type = std::uint64_t;
+
+			static constexpr std::uint32_t size = 1;
+
+			static type load ( const std::uint64_t * p_ ) noexcept { return * p_; }
+			static void store ( std::uint64_t * p_, const type x_ ) noexcept { * p_ = x_; }
+			static type zero ( ) noexcept { return 0; }
+			static type broadcast ( const std::uint64_t x_ ) noexcept { return x_; }
+			static type and_ ( const type a_, const type b_ ) noexcept { return a_ & b_; }
+			static type xor_ ( const type a_, const type b_ ) noexcept { return a_ ^ b_; }
+			static type add ( const type a_, const type b_ ) noexcept { return a_ + b_; }
+			static type shiftLeft ( const type x_, const std::uint32_t s_ ) noexcept { return x_ << s_; }
+			static type shiftRight ( const type x_, const std::uint32_t s_ ) noexcept { return x_ >> s_; }
+			static type popcount ( const type x_ ) noexcept { return type ( _mm_popcnt_u64 ( x_ ) ); }
+
+#endif
+		};
+	}
+}
+
+template<typename T>
+class bic_matrix {
+
+public:
+
+	static constexpr std::uint32_t bits = sizeof ( T ) * 8;
+
+private:
+
+	using lanes = inthashing::detail::bic_lanes;
+
+	static_assert ( bits % lanes::size == 0, "bic_matrix: the lanes divide the input bits" );
+
+	// A block is 4 x 64 samples, the counts are updated once a block...
+
+	static constexpr std::uint32_t transposed = 64, block = 4 * transposed, words = ( bits + 63 ) / 64, pairs = bits * ( bits + 1 ) / 2;
+
+	std::vector<std::uint64_t> m_rows; // [ words ] [ block ] [ bits ], word w of the differences of the pending samples
+	std::uint32_t m_pending = 0;
+
+	std::vector<std::uint64_t> m_counts; // [ pairs ] [ bits ], j <= k
+	std::uint64_t m_samples = 0;
+
+	static std::size_t pair ( const std::uint32_t j_, const std::uint32_t k_ ) noexcept {
+
+		return std::size_t ( j_ ) * bits - std::size_t ( j_ ) * ( j_ - 1 ) / 2 + ( k_ - j_ );
+	}
+
+	std::uint64_t count ( const std::uint32_t i_, const std::uint32_t j_, const std::uint32_t k_ ) const noexcept {
+
+		return m_counts [ ( j_ <= k_ ? pair ( j_, k_ ) : pair ( k_, j_ ) ) * bits + i_ ];
+	}
+
+	std::uint64_t * row ( const std::uint32_t w_, const std::uint32_t s_ ) noexcept {
+
+		return & m_rows [ ( std::size_t ( w_ ) * block + s_ ) * bits ];
+	}
+
+	// Column j of the 64 samples from s_ on, once transposed...
+
+	const std::uint64_t * column ( const std::uint32_t s_, const std::uint32_t j_ ) const noexcept {
+
+		return & m_rows [ ( std::size_t ( j_ / 64 ) * block + s_ + j_ % 64 ) * bits ];
+	}
+
+	// The 64 rows from a_ on, in place, in every lane: bit b of row s goes
+	// to bit s of row b...
+
+	static void transpose ( std::uint64_t * a_ ) noexcept {
+
+		std::uint64_t m = 0x00000000FFFFFFFF;
+
+		for ( std::uint32_t j = 32; j; j >>= 1, m ^= m << j ) {
+
+			const lanes::type mask = lanes::broadcast ( m );
+
+			for ( std::uint32_t k = 0; k < 64; k = ( ( k | j ) + 1 ) & ~j ) {
+
+				std::uint64_t * a = a_ + std::size_t ( k ) * bits, * b = a_ + std::size_t ( k | j ) * bits;
+
+				for ( std::uint32_t i = 0; i < bits; i += lanes::size ) {
+
+					const lanes::type x = lanes::load ( a + i ), y = lanes::load ( b + i );
+					const lanes::type t = lanes::and_ ( lanes::xor_ ( lanes::shiftRight ( x, j ), y ), mask );
+
+					lanes::store ( a + i, lanes::xor_ ( x, lanes::shiftLeft ( t, j ) ) );
+					lanes::store ( b + i, lanes::xor_ ( y, t ) );
+				}
+			}
+		}
+	}
+
+public:
+
+	bic_matrix ( ) : m_rows ( std::size_t ( words ) * block * bits, 0 ), m_counts ( std::size_t ( pairs ) * bits, 0 ) { }
+
+	// Back to no samples, without giving the (1.2 MB for 64 bits) memory back...
+
+	void clear ( ) noexcept {
+
+		std::fill ( std::begin ( m_counts ), std::end ( m_counts ), 0 );
+
+		m_pending = 0;
+		m_samples = 0;
+	}
+
+	// d_ [ i ] = hash ( x ) ^ hash ( x ^ ( 1 << i ) )...
+
+	void add ( const T * d_ ) noexcept {
+
+		for ( std::uint32_t w = 0; w < words; ++w ) {
+
+			std::uint64_t * r = row ( w, m_pending );
+
+			for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+				r [ i ] = std::uint64_t ( d_ [ i ] >> ( 64 * w ) );
+			}
+		}
+
+		if ( ++m_pending == block ) {
+
+			flush ( );
+		}
+	}
+
+	void flush ( ) noexcept {
+
+		if ( not m_pending ) {
+
+			return;
+		}
+
+		// The rows past m_pending are left overs, zeroed, they count nothing...
+
+		const std::uint32_t used = ( m_pending + transposed - 1 ) / transposed;
+
+		for ( std::uint32_t w = 0; w < words; ++w ) {
+
+			std::fill ( row ( w, m_pending ), row ( w, used * transposed ), 0 );
+
+			for ( std::uint32_t s = 0; s < used * transposed; s += transposed ) {
+
+				transpose ( row ( w, s ) );
+			}
+		}
+
+		for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+			for ( std::uint32_t k = j; k < bits; ++k ) {
+
+				std::uint64_t * counts = & m_counts [ pair ( j, k ) * bits ];
+
+				for ( std::uint32_t i = 0; i < bits; i += lanes::size ) {
+
+					lanes::type sum = lanes::zero ( );
+
+					for ( std::uint32_t s = 0; s < used * transposed; s += transposed ) {
+
+						sum = lanes::add ( sum, lanes::popcount ( lanes::and_ ( lanes::load ( column ( s, j ) + i ), lanes::load ( column ( s, k ) + i ) ) ) );
+					}
+
+					lanes::store ( counts + i, lanes::add ( lanes::load ( counts + i ), sum ) );
+				}
+			}
+		}
+
+		m_samples += m_pending;
+		m_pending = 0;
+	}
+
+	void merge ( bic_matrix & rhs_ ) noexcept {
+
+		flush ( );
+		rhs_.flush ( );
+
+		for ( std::size_t i = 0; i < m_counts.size ( ); ++i ) {
+
+			m_counts [ i ] += rhs_.m_counts [ i ];
+		}
+
+		m_samples += rhs_.m_samples;
+	}
+
+	std::uint64_t samples ( ) const noexcept {
+
+		return m_samples;
+	}
+
+	// Pearson correlation of the flips of output bits j_ and k_ when input
+	// bit i_ flips, 0 is ideal...
+
+	double correlation ( const std::uint32_t i_, const std::uint32_t j_, const std::uint32_t k_ ) const noexcept {
+
+		const double n = double ( m_samples );
+
+		const double pj = double ( count ( i_, j_, j_ ) ) / n, pk = double ( count ( i_, k_, k_ ) ) / n;
+		const double pjk = double ( count ( i_, j_, k_ ) ) / n;
+		const double v = pj * ( 1.0 - pj ) * pk * ( 1.0 - pk );
+
+		// An output bit that never (or always) flips is as dependent as it gets...
+
+		return v > 0.0 ? ( pjk - pj * pk ) / std::sqrt ( v ) : 1.0;
+	}
+
+	double max_correlation ( ) const noexcept {
+
+		double max = 0.0;
+
+		for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+			for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+				for ( std::uint32_t k = j + 1; k < bits; ++k ) {
+
+					max = std::max ( max, std::abs ( correlation ( i, j, k ) ) );
+				}
+			}
+		}
+
+		return max;
+	}
+
+	double rms_correlation ( ) const noexcept {
+
+		double sum = 0.0;
+
+		for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+			for ( std::uint32_t j = 0; j < bits; ++j ) {
+
+				for ( std::uint32_t k = j + 1; k < bits; ++k ) {
+
+					const double c = correlation ( i, j, k );
+
+					sum += c * c;
+				}
+			}
+		}
+
+		return std::sqrt ( sum / ( double ( bits ) * double ( bits * ( bits - 1 ) / 2 ) ) );
+	}
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
+#include "worker_pool.hpp"
+
+
+// Exhaustive verification, for widths up to 32 bits, that a hash is a
+// permutation and that an unhash undoes it, over every input, odd and even.
+// The domain is cut into chunks, hashed and unhashed by the batch functions
+// (so the SIMD kernels do the work), on the worker pool. Every output sets
+// its bit in a bitset of the whole domain (512 MiB at 32 bits), a bit that
+// was set already is a collision. No collision over the whole domain is a
+// permutation, the domain and the range being the same set...
+
+namespace inthashing {
+
+	struct bijection_result {
+
+		bool permutation, inverse;
+		std::uint64_t collisions, mismatches; // counts
+		std::uint64_t first_collision, first_mismatch; // the lowest inputs caught, 2^w if none; of two colliding inputs, the one that came second
+	};
+
+	// hash_ ( x, y, n ) and unhash_ ( x, y, n ) map n values of x into y...
+
+	template<typename T, typename Hash, typename UnHash>
+	bijection_result verifyBijection ( const Hash & hash_, const UnHash & unhash_ ) {
+
+		static_assert ( sizeof ( T ) <= 4, "verifyBijection: up to 32 bits" );
+
+		constexpr std::uint64_t domain = std::uint64_t ( std::numeric_limits<T>::max ( ) ) + 1;
+		constexpr std::size_t chunk = std::size_t ( std::min<std::uint64_t> ( domain, 1 << 14 ) ), words = std::size_t ( ( domain + 63 ) / 64 );
+
+		const std::unique_ptr<std::atomic<std::uint64_t> [ ]> bits ( new std::atomic<std::uint64_t> [ words ] );
+
+		workers ( ).parallel_for ( words, [ & ] ( const std::size_t i ) { bits [ i ].store ( 0, std::memory_order_relaxed ); }, 1 << 16 );
+
+		std::atomic<std::uint64_t> collisions ( 0 ), mismatches ( 0 );
+		std::atomic<std::uint64_t> first_collision ( domain ), first_mismatch ( domain );
+
+		const auto lowest = [ ] ( std::atomic<std::uint64_t> & first_, const std::uint64_t x_ ) {
+
+			std::uint64_t f = first_.load ( std::memory_order_relaxed );
+
+			while ( x_ < f and not first_.compare_exchange_weak ( f, x_, std::memory_order_relaxed ) ) { }
+		};
+
+		workers ( ).parallel_for ( std::size_t ( domain / chunk ), [ & ] ( const std::size_t c_ ) {
+
+			alignas ( 64 ) T x [ chunk ], y [ chunk ], z [ chunk ];
+
+			const std::uint64_t base = std::uint64_t ( c_ ) * chunk;
+
+			for ( std::size_t i = 0; i < chunk; ++i ) {
+
+				x [ i ] = T ( base + i );
+			}
+
+			hash_ ( x, y, chunk );
+			unhash_ ( y, z, chunk );
+
+			std::uint64_t c = 0, m = 0, fc = domain, fm = domain;
+
+			for ( std::size_t i = 0; i < chunk; ++i ) {
+
+				const std::uint64_t bit = std::uint64_t ( 1 ) << ( y [ i ] & 63 );
+
+				if ( bits [ std::size_t ( y [ i ] ) >> 6 ].fetch_or ( bit, std::memory_order_relaxed ) & bit ) {
+
+					fc = std::min<std::uint64_t> ( fc, base + i );
+					++c;
+				}
+
+				if ( z [ i ] != x [ i ] ) {
+
+					fm = std::min<std::uint64_t> ( fm, base + i );
+					++m;
+				}
+			}
+
+			if ( c ) {
+
+				collisions.fetch_add ( c, std::memory_order_relaxed );
+				lowest ( first_collision, fc );
+			}
+
+			if ( m ) {
+
+				mismatches.fetch_add ( m, std::memory_order_relaxed );
+				lowest ( first_mismatch, fm );
+			}
+		}, 1 );
+
+		return { not collisions.load ( ), not mismatches.load ( ), collisions.load ( ), mismatches.load ( ), first_collision.load ( ), first_mismatch.load ( ) };
+	}
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// Search checkpoints. A file is a header followed by one record per
+// candidate. Files are written to a temporary next to the target, synced
+// to the disk, and then renamed over it, the rename synced as well (the
+// directory, on POSIX), so a crash, power loss included, leaves either the
+// old or the new checkpoint, never a torn one; the checksum catches what a
+// file system that doesn't honour the syncs lets through...
+
+template<typename T>
+struct checkpoint_record {
+
+	T value, value2;
+	std::uint64_t variant, evaluations, ctr;
+	double score, m2;
+	std::uint64_t histogram [ sizeof ( T ) * 8 + 1 ]; // popcount_histogram bins
+};
+
+struct checkpoint_header {
+
+	char magic [ 8 ];
+	std::uint32_t version, width;
+	std::uint64_t generation, size;
+	std::uint64_t rng [ 2 ];
+	std::uint64_t checksum;
+
+	static constexpr char signature [ 8 ] { 'I', 'H', 'C', 'K', 'P', 'T', '\0', '\0' };
+	static constexpr std::uint32_t current_version = 3;
+};
+
+template<typename T>
+struct checkpoint {
+
+	std::uint64_t generation = 0;
+	std::uint64_t rng [ 2 ] = { };
+	std::vector<checkpoint_record<T>> records;
+};
+
+
+namespace detail {
+
+	inline std::uint64_t checkpointChecksum ( const void * p_, const std::size_t n_ ) noexcept {
+
+		// FNV-1a...
+
+		const unsigned char * p = ( const unsigned char * ) p_;
+		std::uint64_t h = 0xCBF29CE484222325;
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			h = ( h ^ p [ i ] ) * 0x100000001B3;
+		}
+
+		return h;
+	}
+
+	// Writes n_ bytes of p_ to f_ and forces them out to the disk...
+
+	inline bool writeSynced ( std::FILE * f_, const void * p_, const std::size_t n_ ) noexcept {
+
+		if ( std::fwrite ( p_, 1, n_, f_ ) != n_ or std::fflush ( f_ ) ) {
+
+			return false;
+		}
+
+#ifdef _WIN32
+		return not _commit ( _fileno ( f_ ) );
+#else
+		return not ::fsync ( fileno ( f_ ) );
+#endif
+	}
+
+	// Renames from_ over to_, on return the rename is on the disk...
+
+	inline bool renameSynced ( const std::string & from_, const std::string & to_ ) noexcept {
+
+#ifdef _WIN32
+		return MoveFileExA ( from_.c_str ( ), to_.c_str ( ), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH );
+#else
+		if ( std::rename ( from_.c_str ( ), to_.c_str ( ) ) ) {
+
+			return false;
+		}
+
+		const std::string directory = std::filesystem::path ( to_ ).parent_path ( ).string ( );
+		const int fd = ::open ( directory.empty ( ) ? "." : directory.c_str ( ), O_RDONLY | O_DIRECTORY );
+
+		if ( fd < 0 ) {
+
+			return false;
+		}
+
+		const bool synced = not ::fsync ( fd );
+
+		::close ( fd );
+
+		return synced;
+#endif
+	}
+}
+
+
+template<typename T>
+bool saveCheckpoint ( const std::string & path_, const checkpoint<T> & checkpoint_ ) {
+
+	checkpoint_header header;
+
+	std::memcpy ( header.magic, checkpoint_header::signature, sizeof ( header.magic ) );
+	header.version = checkpoint_header::current_version;
+	header.width = sizeof ( T ) * 8;
+	header.generation = checkpoint_.generation;
+	header.size = checkpoint_.records.size ( );
+	header.rng [ 0 ] = checkpoint_.rng [ 0 ];
+	header.rng [ 1 ] = checkpoint_.rng [ 1 ];
+	header.checksum = detail::checkpointChecksum ( checkpoint_.records.data ( ), checkpoint_.records.size ( ) * sizeof ( checkpoint_record<T> ) );
+
+	const std::string tmp = path_ + ".tmp";
+
+	std::FILE * file = std::fopen ( tmp.c_str ( ), "wb" );
+
+	if ( not file ) {
+
+		return false;
+	}
+
+	const bool written = std::fwrite ( & header, sizeof ( header ), 1, file ) == 1 and detail::writeSynced ( file, checkpoint_.records.data ( ), checkpoint_.records.size ( ) * sizeof ( checkpoint_record<T> ) );
+
+	if ( std::fclose ( file ) or not written ) {
+
+		return false;
+	}
+
+	return detail::renameSynced ( tmp, path_ );
+}
+
+// Maps the file and copies it out, false if there is no (valid) checkpoint
+// for this width...
+
+template<typename T>
+bool loadCheckpoint ( const std::string & path_, checkpoint<T> & checkpoint_ ) {
+
+	std::error_code error;
+
+	if ( not std::filesystem::exists ( path_, error ) or std::filesystem::file_size ( path_, error ) < sizeof ( checkpoint_header ) ) {
+
+		return false;
+	}
+
+	try {
+
+		const boost::interprocess::file_mapping file ( path_.c_str ( ), boost::interprocess::read_only );
+		const boost::interprocess::mapped_region region ( file, boost::interprocess::read_only );
+
+		const char * base = ( const char * ) region.get_address ( );
+
+		checkpoint_header header;
+
+		std::memcpy ( & header, base, sizeof ( header ) );
+
+		const std::size_t size = header.size * sizeof ( checkpoint_record<T> );
+
+		if ( std::memcmp ( header.magic, checkpoint_header::signature, sizeof ( header.magic ) ) or header.version != checkpoint_header::current_version or header.width != sizeof ( T ) * 8 or region.get_size ( ) < sizeof ( header ) + size ) {
+
+			return false;
+		}
+
+		if ( detail::checkpointChecksum ( base + sizeof ( header ), size ) != header.checksum ) {
+
+			return false;
+		}
+
+		checkpoint_.generation = header.generation;
+		checkpoint_.rng [ 0 ] = header.rng [ 0 ];
+		checkpoint_.rng [ 1 ] = header.rng [ 1 ];
+		checkpoint_.records.resize ( header.size );
+
+		std::memcpy ( checkpoint_.records.data ( ), base + sizeof ( header ), size );
+	}
+
+	catch ( const boost::interprocess::interprocess_exception & ) {
+
+		return false;
+	}
+
+	return true;
+}
+
+
+// Writes checkpoints on a background thread. submit ( ) only moves the
+// snapshot in, if the writer is still busy with an older one the newer
+// snapshot replaces whatever was still pending...
+
+template<typename T>
+class checkpoint_writer {
+
+	std::string m_path;
+
+	std::mutex m_mutex;
+	std::condition_variable m_pending_cv;
+
+	checkpoint<T> m_pending;
+	bool m_has_pending = false, m_stop = false;
+
+	std::thread m_thread;
+
+	void work ( ) {
+
+		checkpoint<T> current;
+
+		while ( true ) {
+
+			{
+				std::unique_lock<std::mutex> lock ( m_mutex );
+
+				m_pending_cv.wait ( lock, [ & ] ( ) { return m_stop or m_has_pending; } );
+
+				if ( not m_has_pending ) {
+
+					return;
+				}
+
+				std::swap ( current, m_pending );
+				m_has_pending = false;
+			}
+
+			if ( not saveCheckpoint ( m_path, current ) ) {
+
+				std::fprintf ( stderr, "checkpoint: writing %s failed\n", m_path.c_str ( ) );
+			}
+		}
+	}
+
+public:
+
+	explicit checkpoint_writer ( std::string path_ ) : m_path ( std::move ( path_ ) ), m_thread ( [ this ] ( ) { work ( ); } ) { }
+
+	checkpoint_writer ( const checkpoint_writer & ) = delete;
+	checkpoint_writer & operator = ( const checkpoint_writer & ) = delete;
+
+	// Writes what is still pending before returning...
+
+	~checkpoint_writer ( ) {
+
+		{
+			std::lock_guard<std::mutex> lock ( m_mutex );
+
+			m_stop = true;
+		}
+
+		m_pending_cv.notify_one ( );
+		m_thread.join ( );
+	}
+
+	void submit ( checkpoint<T> && checkpoint_ ) {
+
+		{
+			std::lock_guard<std::mutex> lock ( m_mutex );
+
+			m_pending = std::move ( checkpoint_ );
+			m_has_pending = true;
+		}
+
+		m_pending_cv.notify_one ( );
+	}
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <vector>
+
+
+// Multi-bit input differences. Single bit flips are what Ksac tests, real
+// keys tend to differ in a few neighbouring bits (a counter that carries,
+// a field that's bumped), so the differential scorer runs over a fixed set
+// of those:
+//
+//     adjacent: 2 and 3 bit runs at every position, x ^ run,
+//     pair:     two random bits, x ^ pair,
+//     delta:    small additive deltas, x + delta, carries included...
+
+namespace inthashing {
+
+	enum class difference_kind : std::uint32_t { adjacent, pair, delta };
+
+	inline const char * differenceKindName ( const difference_kind k_ ) noexcept {
+
+		static const char * names [ ] = { "adjacent", "pair", "delta" };
+
+		return names [ std::uint32_t ( k_ ) ];
+	}
+
+	template<typename T>
+	struct input_difference {
+
+		difference_kind kind;
+		T value; // the xor mask, or the delta
+
+		T operator ( ) ( const T x_ ) const noexcept {
+
+			return kind == difference_kind::delta ? T ( x_ + value ) : T ( x_ ^ value );
+		}
+	};
+
+
+	// The set, pairs_ random pairs and deltas_ random deltas in [ 1, 256 ),
+	// delta 1 always included. rng_ should be seeded the same for every
+	// candidate, so they are all measured against the same differences...
+
+	template<typename T, typename Engine>
+	std::vector<input_difference<T>> makeDifferences ( Engine & rng_, const std::size_t pairs_, const std::size_t deltas_ ) {
+
+		constexpr std::uint32_t bits = sizeof ( T ) * 8;
+
+		std::vector<input_difference<T>> differences;
+
+		for ( std::uint32_t k = 2; k <= 3; ++k ) {
+
+			for ( std::uint32_t p = 0; p + k <= bits; ++p ) {
+
+				differences.push_back ( { difference_kind::adjacent, T ( T ( ( 1u << k ) - 1 ) << p ) } );
+			}
+		}
+
+		for ( std::size_t i = 0; i < pairs_; ++i ) {
+
+			const std::uint32_t a = std::uint32_t ( rng_ ( ) % bits ), b = ( a + 1 + std::uint32_t ( rng_ ( ) % ( bits - 1 ) ) ) % bits;
+
+			differences.push_back ( { difference_kind::pair, T ( ( T ( 1 ) << a ) | ( T ( 1 ) << b ) ) } );
+		}
+
+		differences.push_back ( { difference_kind::delta, T ( 1 ) } );
+
+		for ( std::size_t i = 1; i < deltas_; ++i ) {
+
+			differences.push_back ( { difference_kind::delta, T ( 1 + rng_ ( ) % 255 ) } );
+		}
+
+		return differences;
+	}
+
+	// y_ [ i ] = d_ ( x_ [ i ] ), branch free inside the loop, so it vectorizes...
+
+	template<typename T>
+	void applyDifference ( const input_difference<T> & d_, const T * x_, T * y_, const std::size_t n_ ) noexcept {
+
+		const T v = d_.value;
+
+		if ( d_.kind == difference_kind::delta ) {
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				y_ [ i ] = T ( x_ [ i ] + v );
+			}
+		}
+
+		else {
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				y_ [ i ] = T ( x_ [ i ] ^ v );
+			}
+		}
+	}
+}
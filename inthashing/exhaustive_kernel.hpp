@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <immintrin.h>
+
+#include "inthashing.hpp"
+
+
+// Exhaustive scoring of the 8- and 16-bit classic mixer, classic_mixer<T>,
+// from a table: the multiplier's hashes of the whole domain go in first (64K
+// entries, 128 KB, at 16 bits, it stays in L2), then every single bit flip is
+// two lookups, h [ x ] ^ h [ x ^ 1 << i ]. The partner of x is a fixed distance
+// away, for a block of x's the block of partners is a plain load, or, within
+// a register, a shuffle, nothing needs a gather. A pair is the same both
+// ways, each is scored once and counted twice. The sums are those of
+// getTotalFsacSquaredDeviation ( ), exactly, inthashing::hash ( ) is the
+// classic mixer at both widths...
+
+namespace inthashing {
+
+	template<typename T>
+	struct domain {
+
+		static_assert ( sizeof ( T ) <= 2, "domain: 8 or 16 bits" );
+
+		static constexpr std::uint32_t bits = sizeof ( T ) * 8;
+		static constexpr std::size_t size = std::size_t ( 1 ) << bits;
+	};
+
+	namespace detail {
+
+		template<typename T>
+		void hashDomainScalar ( const T m_, T * h_ ) noexcept {
+
+			const classic_mixer<T> h { { m_, m_ } };
+
+			for ( std::size_t x = 0; x < domain<T>::size; ++x ) {
+
+				h_ [ x ] = h ( T ( x ) );
+			}
+		}
+
+		// The pairs x, x ^ 1 << i_ for all x with bit i_ clear, the sum of
+		// their ( popcount ( h [ x ] ^ h [ x ^ 1 << i_ ] ) - w / 2 )^2...
+
+		template<typename T>
+		std::uint64_t bitSquaredDeviationScalar ( const T * h_, const std::uint32_t i_ ) noexcept {
+
+			constexpr std::int32_t half = domain<T>::bits / 2;
+
+			const std::size_t s = std::size_t ( 1 ) << i_;
+
+			std::uint64_t sum = 0;
+
+			for ( std::size_t b = 0; b < domain<T>::size; b += 2 * s ) {
+
+				for ( std::size_t x = b; x < b + s; ++x ) {
+
+					const std::int32_t d = std::int32_t ( _mm_popcnt_u32 ( std::uint32_t ( h_ [ x ] ^ h_ [ x + s ] ) ) ) - half;
+
+					sum += std::uint64_t ( d * d );
+				}
+			}
+
+			return sum;
+		}
+
+#ifdef __AVX2__
+
+		// 16 lanes of the 16-bit hash, mullo keeps the low 16 bits, as the
+		// scalar multiply does...
+
+		inline void hashDomainAvx2 ( const std::uint16_t m_, std::uint16_t * h_ ) noexcept {
+
+			const __m256i m = _mm256_set1_epi16 ( std::int16_t ( m_ ) ), step = _mm256_set1_epi16 ( 16 );
+
+			__m256i x = _mm256_setr_epi16 ( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+
+			for ( std::size_t b = 0; b < domain<std::uint16_t>::size; b += 16, x = _mm256_add_epi16 ( x, step ) ) {
+
+				__m256i y = _mm256_mullo_epi16 ( _mm256_xor_si256 ( _mm256_srli_epi16 ( x, 8 ), x ), m );
+
+				y = _mm256_mullo_epi16 ( _mm256_xor_si256 ( _mm256_srli_epi16 ( y, 8 ), y ), m );
+
+				_mm256_store_si256 ( ( __m256i * ) ( h_ + b ), _mm256_xor_si256 ( _mm256_srli_epi16 ( y, 8 ), y ) );
+			}
+		}
+
+		// Sums of ( popcount - w / 2 )^2 over the lanes of d_, in 8 32-bit
+		// lanes. Nibble lookup popcounts per byte, the bytes of a 16-bit lane
+		// added by maddubs...
+
+		template<typename T>
+		__m256i squaredDeviation ( const __m256i d_ ) noexcept {
+
+			const __m256i lookup = _mm256_setr_epi8 ( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+			const __m256i nibble = _mm256_set1_epi8 ( 0x0F );
+
+			const __m256i c = _mm256_add_epi8 ( _mm256_shuffle_epi8 ( lookup, _mm256_and_si256 ( d_, nibble ) ), _mm256_shuffle_epi8 ( lookup, _mm256_and_si256 ( _mm256_srli_epi16 ( d_, 4 ), nibble ) ) );
+
+			if constexpr ( sizeof ( T ) == 1 ) {
+
+				// | c - 4 | <= 4, its square and the neighbour's in 16 bits...
+
+				const __m256i a = _mm256_abs_epi8 ( _mm256_sub_epi8 ( c, _mm256_set1_epi8 ( 4 ) ) );
+
+				return _mm256_madd_epi16 ( _mm256_maddubs_epi16 ( a, a ), _mm256_set1_epi16 ( 1 ) );
+			}
+
+			else {
+
+				const __m256i a = _mm256_sub_epi16 ( _mm256_maddubs_epi16 ( c, _mm256_set1_epi8 ( 1 ) ), _mm256_set1_epi16 ( 8 ) );
+
+				return _mm256_madd_epi16 ( a, a );
+			}
+		}
+
+		inline std::uint64_t horizontalAdd32 ( const __m256i x_ ) noexcept {
+
+			const __m256i s = _mm256_add_epi64 ( _mm256_cvtepu32_epi64 ( _mm256_castsi256_si128 ( x_ ) ), _mm256_cvtepu32_epi64 ( _mm256_extracti128_si256 ( x_, 1 ) ) );
+			const __m128i t = _mm_add_epi64 ( _mm256_castsi256_si128 ( s ), _mm256_extracti128_si256 ( s, 1 ) );
+
+			return std::uint64_t ( _mm_cvtsi128_si64 ( t ) ) + std::uint64_t ( _mm_extract_epi64 ( t, 1 ) );
+		}
+
+		// As bitSquaredDeviationScalar ( ), 32 bytes at a time. Partners a
+		// register or more apart are loaded, partners within a 16-byte lane
+		// are a byte shuffle away, across the two lanes a lane swap...
+
+		template<typename T>
+		std::uint64_t bitSquaredDeviationAvx2 ( const T * h_, const std::uint32_t i_ ) noexcept {
+
+			constexpr std::size_t lanes = 32 / sizeof ( T );
+
+			const std::size_t s = std::size_t ( 1 ) << i_, distance = s * sizeof ( T ); // in bytes
+
+			__m256i acc = _mm256_setzero_si256 ( );
+
+			if ( s >= lanes ) {
+
+				for ( std::size_t b = 0; b < domain<T>::size; b += 2 * s ) {
+
+					for ( std::size_t x = b; x < b + s; x += lanes ) {
+
+						const __m256i d = _mm256_xor_si256 ( _mm256_load_si256 ( ( const __m256i * ) ( h_ + x ) ), _mm256_load_si256 ( ( const __m256i * ) ( h_ + x + s ) ) );
+
+						acc = _mm256_add_epi32 ( acc, squaredDeviation<T> ( d ) );
+					}
+				}
+
+				return horizontalAdd32 ( acc );
+			}
+
+			// Every pair twice, x and its partner are both in the register...
+
+			const __m256i partner = _mm256_xor_si256 ( _mm256_setr_epi8 ( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 ), _mm256_set1_epi8 ( char ( distance & 15 ) ) );
+
+			for ( std::size_t x = 0; x < domain<T>::size; x += lanes ) {
+
+				const __m256i a = _mm256_load_si256 ( ( const __m256i * ) ( h_ + x ) );
+				const __m256i p = distance == 16 ? _mm256_permute2x128_si256 ( a, a, 0x01 ) : _mm256_shuffle_epi8 ( a, partner );
+
+				acc = _mm256_add_epi32 ( acc, squaredDeviation<T> ( _mm256_xor_si256 ( a, p ) ) );
+			}
+
+			return horizontalAdd32 ( acc ) / 2;
+		}
+
+#endif
+	}
+
+
+	// h_ [ x ] = classic_mixer<T> { { m_, m_ } } ( x ) for the whole domain, h_ 32-byte
+	// aligned...
+
+	template<typename T>
+	void hashDomain ( const T m_, T * h_ ) noexcept {
+
+#ifdef __AVX2__
+
+		if constexpr ( sizeof ( T ) == 2 ) {
+
+			detail::hashDomainAvx2 ( m_, h_ );
+
+			return;
+		}
+
+#endif
+
+		detail::hashDomainScalar ( m_, h_ );
+	}
+
+	// The sum over all x and bits i of ( popcount ( h_ [ x ] ^ h_ [ x ^ 1 << i ] ) - w / 2 )^2,
+	// a table from hashDomain ( ). Gives up (returning a value > bound_) as
+	// soon as the partial sum exceeds bound_, checked after every bit...
+
+	template<typename T>
+	std::uint64_t domainSquaredDeviation ( const T * h_, const std::uint64_t bound_ ) noexcept {
+
+		std::uint64_t sum = 0;
+
+		for ( std::uint32_t i = 0; i < domain<T>::bits and sum <= bound_; ++i ) {
+
+#ifdef __AVX2__
+			sum += 2 * detail::bitSquaredDeviationAvx2 ( h_, i );
+#else
+			sum += 2 * detail::bitSquaredDeviationScalar ( h_, i );
+#endif
+		}
+
+		return sum;
+	}
+}
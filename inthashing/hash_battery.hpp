@@ -0,0 +1,388 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <integer_utils.hpp>
+
+#include "worker_pool.hpp"
+
+
+// Statistical tests on the outputs of a hash over a batch of keys, the SAC
+// scorers say nothing about how the outputs spread over a table. Every test
+// reports a z-score, normal under the null hypothesis (chi-square statistics
+// through the Wilson-Hilferty transform), so one threshold fits all. The
+// hashes are permutations, the null hypothesis is a random one: the outputs
+// of distinct keys are then drawn without replacement from the 2^w values,
+// a sizeable part of them at 8 and 16 bits. Repeated outputs (of repeated
+// keys) are dropped, at most a quarter of the domain is tested, and the
+// expectations and variances are those of sampling without replacement...
+
+namespace inthashing {
+
+	struct battery_result {
+
+		const char * name;
+		std::uint64_t parameter; // table size, bits or gap bits, depending on the test
+		double statistic, expected, z;
+	};
+
+	constexpr double battery_threshold = 4.0;
+
+	inline bool batteryPasses ( const std::vector<battery_result> & results_, const double threshold_ = battery_threshold ) noexcept {
+
+		return std::all_of ( std::begin ( results_ ), std::end ( results_ ), [ threshold_ ] ( const battery_result & r_ ) { return std::abs ( r_.z ) < threshold_; } );
+	}
+
+	inline double worstZ ( const std::vector<battery_result> & results_ ) noexcept {
+
+		double z = 0.0;
+
+		for ( const battery_result & r : results_ ) {
+
+			z = std::max ( z, std::abs ( r.z ) );
+		}
+
+		return z;
+	}
+
+
+	namespace detail {
+
+		// Chi-square with df_ degrees of freedom to a standard normal...
+
+		inline double chiSquareZ ( const double chi2_, const double df_ ) noexcept {
+
+			const double v = 2.0 / ( 9.0 * df_ );
+
+			return ( std::cbrt ( chi2_ / df_ ) - ( 1.0 - v ) ) / std::sqrt ( v );
+		}
+
+		template<typename T>
+		constexpr std::uint32_t bits ( ) noexcept {
+
+			return std::uint32_t ( sizeof ( T ) * 8 );
+		}
+
+		// 2^w, the number of values the outputs are drawn from...
+
+		template<typename T>
+		double domain ( ) noexcept {
+
+			return std::ldexp ( 1.0, int ( bits<T> ( ) ) );
+		}
+
+		// The falling factorial x ( x - 1 ) ... ( x - k_ + 1 )...
+
+		inline double falling ( const double x_, const std::uint32_t k_ ) noexcept {
+
+			double f = 1.0;
+
+			for ( std::uint32_t i = 0; i < k_; ++i ) {
+
+				f *= x_ - double ( i );
+			}
+
+			return f;
+		}
+
+		// The outputs h_ in order, each value only the first time it occurs...
+
+		template<typename T>
+		std::vector<T> firstOccurrences ( const T * h_, const std::size_t n_ ) {
+
+			std::vector<std::pair<T, std::size_t>> sorted ( n_ );
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				sorted [ i ] = { h_ [ i ], i };
+			}
+
+			std::sort ( std::begin ( sorted ), std::end ( sorted ) );
+
+			std::vector<bool> first ( n_, false );
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				first [ sorted [ i ].second ] = not i or sorted [ i ].first != sorted [ i - 1 ].first;
+			}
+
+			std::vector<T> distinct;
+
+			distinct.reserve ( n_ );
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				if ( first [ i ] ) {
+
+					distinct.push_back ( h_ [ i ] );
+				}
+			}
+
+			return distinct;
+		}
+
+		// Bucket index of h_ in a table of 2^log2_ buckets, from the low or
+		// the high bits...
+
+		template<typename T>
+		std::uint64_t bucket ( const T h_, const std::uint32_t log2_, const bool high_ ) noexcept {
+
+			return high_ ? std::uint64_t ( h_ >> ( bits<T> ( ) - log2_ ) ) : std::uint64_t ( h_ ) & ( ( std::uint64_t ( 1 ) << log2_ ) - 1 );
+		}
+	}
+
+
+	// Hashes n_ keys into h_, in parallel...
+
+	template<typename H, typename T>
+	void hashKeys ( const H & hash_, const T * keys_, T * h_, const std::size_t n_, worker_pool & pool_ = workers ( ) ) {
+
+		constexpr std::size_t grain = 1 << 14;
+
+		pool_.parallel_for ( ( n_ + grain - 1 ) / grain, [ & ] ( const std::size_t c_ ) {
+
+			const std::size_t e = std::min ( n_, ( c_ + 1 ) * grain );
+
+			for ( std::size_t i = c_ * grain; i < e; ++i ) {
+
+				h_ [ i ] = hash_ ( keys_ [ i ] );
+			}
+		}, 1 );
+	}
+
+
+	// Chi-square of the bucket counts of a power of two table, a load of
+	// load_ keys per bucket on average. Without replacement the counts are
+	// hypergeometric, the chi-square is short of its df by the finite
+	// population correction, ( N - n ) / ( N - 1 ), and scaled back up...
+
+	template<typename T>
+	battery_result bucketUniformity ( const T * h_, const std::size_t n_, const std::size_t load_, const bool high_, worker_pool & pool_ = workers ( ) ) {
+
+		const std::uint64_t size = std::min<std::uint64_t> ( jimi::nextPowerOfTwo<std::uint64_t> ( std::max<std::uint64_t> ( 2, n_ / load_ ) ), std::uint64_t ( 1 ) << std::min<std::uint32_t> ( detail::bits<T> ( ), 32 ) );
+		const std::uint32_t log2 = std::uint32_t ( jimi::iLog2<std::uint64_t> ( size ) );
+
+		// One table per worker, each counts a contiguous slice...
+
+		std::vector<std::vector<std::uint32_t>> counts ( pool_.size ( ) );
+
+		pool_.run ( [ & ] ( const std::size_t id_ ) {
+
+			std::vector<std::uint32_t> & c = counts [ id_ ];
+
+			c.assign ( size, 0 );
+
+			const std::size_t b = n_ * id_ / pool_.size ( ), e = n_ * ( id_ + 1 ) / pool_.size ( );
+
+			for ( std::size_t i = b; i < e; ++i ) {
+
+				++c [ detail::bucket ( h_ [ i ], log2, high_ ) ];
+			}
+		} );
+
+		const double expected = double ( n_ ) / double ( size );
+
+		double chi2 = 0.0;
+
+		for ( std::uint64_t i = 0; i < size; ++i ) {
+
+			std::uint64_t c = 0;
+
+			for ( const auto & t : counts ) {
+
+				c += t [ i ];
+			}
+
+			const double d = double ( c ) - expected;
+
+			chi2 += d * d;
+		}
+
+		chi2 *= ( detail::domain<T> ( ) - 1.0 ) / ( expected * ( detail::domain<T> ( ) - double ( n_ ) ) );
+
+		return { high_ ? "chi2 high" : "chi2 low", size, chi2, double ( size - 1 ), detail::chiSquareZ ( chi2, double ( size - 1 ) ) };
+	}
+
+
+	// Colliding pairs among the low or high bits_ bits. Each of the B = 2^bits_
+	// buckets holds K = 2^( w - bits_ ) of the N values, the pairs are
+	// X = sum over the buckets of ( c )_2 / 2, ( x )_k the falling factorial,
+	// and with c hypergeometric E [ ( c )_k ] = ( n )_k ( K )_k / ( N )_k, the
+	// mean and the variance follow exactly, from
+	//
+	//     ( c )_2^2 = ( c )_4 + 4 ( c )_3 + 2 ( c )_2,
+	//     E [ ( c )_2 ( c' )_2 ] = ( n )_4 ( K )_2^2 / ( N )_4 for two buckets...
+
+	template<typename T>
+	battery_result collisions ( const T * h_, const std::size_t n_, const std::uint32_t bits_, const bool high_ ) {
+
+		std::vector<std::uint64_t> v ( n_ );
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			v [ i ] = detail::bucket ( h_ [ i ], bits_, high_ );
+		}
+
+		std::sort ( std::begin ( v ), std::end ( v ) );
+
+		std::uint64_t pairs = 0, run = 0;
+
+		for ( std::size_t i = 1; i < n_; ++i ) {
+
+			run = v [ i ] == v [ i - 1 ] ? run + 1 : 0;
+			pairs += run;
+		}
+
+		using detail::falling;
+
+		const double N = detail::domain<T> ( ), B = std::ldexp ( 1.0, int ( bits_ ) ), K = N / B, n = double ( n_ );
+
+		const double c2 = falling ( n, 2 ) * falling ( K, 2 ) / falling ( N, 2 );
+		const double c3 = falling ( n, 3 ) * falling ( K, 3 ) / falling ( N, 3 );
+		const double c4 = falling ( n, 4 ) * falling ( K, 4 ) / falling ( N, 4 );
+		const double cc = falling ( n, 4 ) * falling ( K, 2 ) * falling ( K, 2 ) / falling ( N, 4 );
+
+		const double expected = B * c2 / 2.0, variance = ( B * ( c4 + 4.0 * c3 + 2.0 * c2 ) + B * ( B - 1.0 ) * cc ) / 4.0 - expected * expected;
+
+		return { high_ ? "collisions high" : "collisions low", bits_, double ( pairs ), expected, variance > 0.0 ? ( double ( pairs ) - expected ) / std::sqrt ( variance ) : 0.0 };
+	}
+
+
+	// Wald-Wolfowitz runs test on bit bit_ of consecutive outputs...
+
+	template<typename T>
+	battery_result runs ( const T * h_, const std::size_t n_, const std::uint32_t bit_ ) noexcept {
+
+		std::uint64_t ones = 0, runs = 1;
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			ones += ( h_ [ i ] >> bit_ ) & 1;
+
+			if ( i ) {
+
+				runs += ( ( h_ [ i ] ^ h_ [ i - 1 ] ) >> bit_ ) & 1;
+			}
+		}
+
+		const double n1 = double ( ones ), n0 = double ( n_ - ones ), n = double ( n_ );
+		const double mu = 2.0 * n1 * n0 / n + 1.0, var = ( mu - 1.0 ) * ( mu - 2.0 ) / ( n - 1.0 );
+
+		return { "runs", bit_, double ( runs ), mu, var > 0.0 ? ( double ( runs ) - mu ) / std::sqrt ( var ) : 0.0 };
+	}
+
+
+	// Gap test: the distances between consecutive outputs with their low
+	// bits_ bits all zero are geometric, p = 2^-bits_. Chi-square over gap
+	// lengths 0 .. classes - 2 and a tail class. Needs 64 << bits_ outputs,
+	// for 8 gaps or so in the last of the classes...
+
+	template<typename T>
+	battery_result gaps ( const T * h_, const std::size_t n_, const std::uint32_t bits_ ) {
+
+		const double p = std::ldexp ( 1.0, -int ( bits_ ) );
+		const std::uint64_t mask = ( std::uint64_t ( 1 ) << bits_ ) - 1;
+		const std::size_t classes = std::size_t ( 4 << bits_ ); // tail probability e^-4
+
+		std::vector<std::uint64_t> counts ( classes, 0 );
+		std::uint64_t total = 0, gap = 0;
+		bool started = false;
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			if ( std::uint64_t ( h_ [ i ] ) & mask ) {
+
+				++gap;
+			}
+
+			else {
+
+				if ( started ) {
+
+					++counts [ std::min<std::uint64_t> ( gap, classes - 1 ) ];
+					++total;
+				}
+
+				started = true;
+				gap = 0;
+			}
+		}
+
+		double chi2 = 0.0, q = 1.0;
+
+		for ( std::size_t g = 0; g < classes; ++g ) {
+
+			const double expected = double ( total ) * ( g < classes - 1 ? p * q : q );
+			const double d = double ( counts [ g ] ) - expected;
+
+			chi2 += expected > 0.0 ? d * d / expected : 0.0;
+			q *= 1.0 - p;
+		}
+
+		return { "gaps", bits_, chi2, double ( classes - 1 ), total ? detail::chiSquareZ ( chi2, double ( classes - 1 ) ) : 0.0 };
+	}
+
+
+	// The whole battery over the outputs h_ of n_ keys, in key order (the
+	// runs and gap tests look at consecutive outputs). Of the distinct ones,
+	// at most a quarter of the domain, see the top...
+
+	template<typename T>
+	std::vector<battery_result> runBattery ( const T * h_, const std::size_t n_, worker_pool & pool_ = workers ( ) ) {
+
+		constexpr std::uint32_t gap_bits = 3;
+
+		std::vector<T> distinct = detail::firstOccurrences ( h_, n_ );
+
+		if ( detail::bits<T> ( ) < 64 ) {
+
+			distinct.resize ( std::min<std::size_t> ( distinct.size ( ), std::size_t ( 1 ) << ( detail::bits<T> ( ) - 2 ) ) );
+		}
+
+		const T * h = distinct.data ( );
+		const std::size_t n = distinct.size ( );
+
+		std::vector<battery_result> results;
+
+		for ( const std::size_t load : { 1, 16 } ) {
+
+			results.push_back ( bucketUniformity ( h, n, load, false, pool_ ) );
+			results.push_back ( bucketUniformity ( h, n, load, true, pool_ ) );
+		}
+
+		// About 32 expected pairs, below the full width for the small types...
+
+		const std::uint32_t collision_bits = std::min ( detail::bits<T> ( ) - 1, std::max ( 8u, 2 * std::uint32_t ( jimi::iLog2<std::uint64_t> ( n ) ) ) - 6 );
+
+		results.push_back ( collisions ( h, n, collision_bits, false ) );
+		results.push_back ( collisions ( h, n, collision_bits, true ) );
+
+		for ( std::uint32_t b = 0; b < 4; ++b ) {
+
+			results.push_back ( runs ( h, n, b ) );
+		}
+
+		if ( n >= std::size_t ( 64 ) << gap_bits ) {
+
+			results.push_back ( gaps ( h, n, gap_bits ) );
+		}
+
+		return results;
+	}
+
+	template<typename H, typename T>
+	std::vector<battery_result> runBattery ( const H & hash_, const T * keys_, const std::size_t n_, worker_pool & pool_ = workers ( ) ) {
+
+		std::vector<T> h ( n_ );
+
+		hashKeys ( hash_, keys_, h.data ( ), n_, pool_ );
+
+		return runBattery ( h.data ( ), n_, pool_ );
+	}
+}
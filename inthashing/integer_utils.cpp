@@ -1,6 +1,9 @@
 
 #include <intrin.h>
 #include <immintrin.h>
+#ifndef _MSC_VER
+#include <cpuid.h>
+#endif
 #define _CRT_RAND_S
 #include <math.h>
 
@@ -44,6 +47,20 @@ namespace jimi {
 	}
 
 
+#ifdef JIMI_HAS_UINT128
+
+	uint128_t modularMultiplicativeInverse ( const uint128_t a_ ) {
+
+		// Given odd a, compute x such that a * x = 1 over 128 bits...
+
+		const uint128_t x = modularMultiplicativeInverse ( ( uint64_t ) a_ ); // low 64 bits of inverse
+
+		return ( 2u - a_ * x ) * x;						//    128 bits of inverse
+	}
+
+#endif
+
+
 	bool isPrime ( const uint32_t n_ ) {
 
 		// Assumes n = odd...
@@ -88,6 +105,249 @@ namespace jimi {
 	}
 
 
+#ifdef JIMI_HAS_UINT128
+
+	uint32_t popCount ( const uint128_t x_ ) {
+
+		return ( uint32_t ) ( __popcnt64 ( ( uint64_t ) x_ ) + __popcnt64 ( ( uint64_t ) ( x_ >> 64 ) ) );
+	}
+
+#endif
+
+
+	// Integer Hashing, in bulk. The kernels are compiled for their own
+	// instruction set, whatever the flags of the translation unit, and only
+	// called if the CPU has it...
+
+#if defined ( _MSC_VER ) and not defined ( __clang__ )
+#define JIMI_TARGET( t_ )
+#else
+#define JIMI_TARGET( t_ ) __attribute__ ( ( target ( t_ ) ) )
+#endif
+
+	namespace {
+
+		enum class hash_kernel { scalar, avx2, avx512 };
+
+		void cpuid ( int r_ [ 4 ], const int leaf_, const int sub_ ) {
+
+#ifdef _MSC_VER
+			__cpuidex ( r_, leaf_, sub_ );
+#else
+			__cpuid_count ( leaf_, sub_, r_ [ 0 ], r_ [ 1 ], r_ [ 2 ], r_ [ 3 ] );
+#endif
+		}
+
+		JIMI_TARGET ( "xsave" ) uint64_t xcr0 ( ) {
+
+			return _xgetbv ( 0 );
+		}
+
+		hash_kernel detectHashKernel ( ) {
+
+			int r [ 4 ];
+
+			cpuid ( r, 0, 0 );
+
+			if ( r [ 0 ] < 7 ) {
+
+				return hash_kernel::scalar;
+			}
+
+			cpuid ( r, 1, 0 );
+
+			if ( not ( r [ 2 ] & ( 1 << 27 ) ) or not ( r [ 2 ] & ( 1 << 28 ) ) ) { // osxsave, avx
+
+				return hash_kernel::scalar;
+			}
+
+			const uint64_t xcr = xcr0 ( );
+
+			cpuid ( r, 7, 0 );
+
+			if ( ( r [ 1 ] & ( 1 << 16 ) ) and ( r [ 1 ] & ( 1 << 17 ) ) and ( xcr & 0xE6 ) == 0xE6 ) { // avx512f, avx512dq, opmask and zmm state
+
+				return hash_kernel::avx512;
+			}
+
+			if ( ( r [ 1 ] & ( 1 << 5 ) ) and ( xcr & 0x6 ) == 0x6 ) { // avx2, ymm state
+
+				return hash_kernel::avx2;
+			}
+
+			return hash_kernel::scalar;
+		}
+
+		hash_kernel hashKernel ( ) {
+
+			static const hash_kernel kernel = detectHashKernel ( );
+
+			return kernel;
+		}
+
+
+		// x = ( ( x >> w / 2 ) ^ x ) * M, twice, then x = ( x >> w / 2 ) ^ x, as
+		// in hash ( ) and unHash ( )...
+
+		template < typename T, T M >
+		void mixScalar ( const T * in_, T * out_, const std::size_t n_ ) {
+
+			constexpr int s = sizeof ( T ) * 4;
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				T x = in_ [ i ];
+
+				x = ( ( x >> s ) ^ x ) * M;
+				x = ( ( x >> s ) ^ x ) * M;
+
+				out_ [ i ] = ( x >> s ) ^ x;
+			}
+		}
+
+		// AVX2 has no 64-bit low multiply: lo ( x ) * lo ( m ) + ( ( hi ( x ) * lo ( m ) + lo ( x ) * hi ( m ) ) << 32 )...
+
+		JIMI_TARGET ( "avx2" ) inline __m256i mullo64Avx2 ( const __m256i x_, const __m256i m_, const __m256i m_hi_ ) {
+
+			const __m256i cross = _mm256_add_epi64 ( _mm256_mul_epu32 ( _mm256_srli_epi64 ( x_, 32 ), m_ ), _mm256_mul_epu32 ( x_, m_hi_ ) );
+
+			return _mm256_add_epi64 ( _mm256_mul_epu32 ( x_, m_ ), _mm256_slli_epi64 ( cross, 32 ) );
+		}
+
+		template < typename T, T M >
+		JIMI_TARGET ( "avx2" ) void mixAvx2 ( const T * in_, T * out_, const std::size_t n_ ) {
+
+			constexpr std::size_t lanes = 32 / sizeof ( T );
+
+			std::size_t i = 0;
+
+			if constexpr ( sizeof ( T ) == 4 ) {
+
+				const __m256i m = _mm256_set1_epi32 ( int ( M ) );
+
+				for ( ; i + lanes <= n_; i += lanes ) {
+
+					__m256i x = _mm256_loadu_si256 ( ( const __m256i * ) ( in_ + i ) );
+
+					x = _mm256_mullo_epi32 ( _mm256_xor_si256 ( _mm256_srli_epi32 ( x, 16 ), x ), m );
+					x = _mm256_mullo_epi32 ( _mm256_xor_si256 ( _mm256_srli_epi32 ( x, 16 ), x ), m );
+
+					_mm256_storeu_si256 ( ( __m256i * ) ( out_ + i ), _mm256_xor_si256 ( _mm256_srli_epi32 ( x, 16 ), x ) );
+				}
+			}
+
+			else {
+
+				const __m256i m = _mm256_set1_epi64x ( int64_t ( M ) ), m_hi = _mm256_set1_epi64x ( int64_t ( M >> 32 ) );
+
+				for ( ; i + lanes <= n_; i += lanes ) {
+
+					__m256i x = _mm256_loadu_si256 ( ( const __m256i * ) ( in_ + i ) );
+
+					x = mullo64Avx2 ( _mm256_xor_si256 ( _mm256_srli_epi64 ( x, 32 ), x ), m, m_hi );
+					x = mullo64Avx2 ( _mm256_xor_si256 ( _mm256_srli_epi64 ( x, 32 ), x ), m, m_hi );
+
+					_mm256_storeu_si256 ( ( __m256i * ) ( out_ + i ), _mm256_xor_si256 ( _mm256_srli_epi64 ( x, 32 ), x ) );
+				}
+			}
+
+			mixScalar < T, M > ( in_ + i, out_ + i, n_ - i );
+		}
+
+		template < typename T, T M >
+		JIMI_TARGET ( "avx512f,avx512dq" ) void mixAvx512 ( const T * in_, T * out_, const std::size_t n_ ) {
+
+			constexpr std::size_t lanes = 64 / sizeof ( T );
+
+			std::size_t i = 0;
+
+			if constexpr ( sizeof ( T ) == 4 ) {
+
+				const __m512i m = _mm512_set1_epi32 ( int ( M ) );
+
+				for ( ; i + lanes <= n_; i += lanes ) {
+
+					__m512i x = _mm512_loadu_si512 ( in_ + i );
+
+					x = _mm512_mullo_epi32 ( _mm512_xor_si512 ( _mm512_srli_epi32 ( x, 16 ), x ), m );
+					x = _mm512_mullo_epi32 ( _mm512_xor_si512 ( _mm512_srli_epi32 ( x, 16 ), x ), m );
+
+					_mm512_storeu_si512 ( out_ + i, _mm512_xor_si512 ( _mm512_srli_epi32 ( x, 16 ), x ) );
+				}
+			}
+
+			else {
+
+				const __m512i m = _mm512_set1_epi64 ( int64_t ( M ) );
+
+				for ( ; i + lanes <= n_; i += lanes ) {
+
+					__m512i x = _mm512_loadu_si512 ( in_ + i );
+
+					x = _mm512_mullo_epi64 ( _mm512_xor_si512 ( _mm512_srli_epi64 ( x, 32 ), x ), m ); // vpmullq
+					x = _mm512_mullo_epi64 ( _mm512_xor_si512 ( _mm512_srli_epi64 ( x, 32 ), x ), m );
+
+					_mm512_storeu_si512 ( out_ + i, _mm512_xor_si512 ( _mm512_srli_epi64 ( x, 32 ), x ) );
+				}
+			}
+
+			mixScalar < T, M > ( in_ + i, out_ + i, n_ - i );
+		}
+
+		template < typename T, T M >
+		void mix ( const T * in_, T * out_, const std::size_t n_ ) {
+
+			using kernel = void ( * ) ( const T *, T *, const std::size_t );
+
+			static const kernel k = [ ] ( ) -> kernel {
+
+				switch ( hashKernel ( ) ) {
+
+					case hash_kernel::avx512: return & mixAvx512 < T, M >;
+					case hash_kernel::avx2: return & mixAvx2 < T, M >;
+					default: return & mixScalar < T, M >;
+				}
+			} ( );
+
+			k ( in_, out_, n_ );
+		}
+	}
+
+
+	// The multipliers of the single value hash ( ) and unHash ( )...
+
+	void hash ( const uint32_t * in_, uint32_t * out_, const std::size_t n_ ) {
+
+		mix < uint32_t, 0x45d9f3b > ( in_, out_, n_ );
+	}
+
+
+	void unHash ( const uint32_t * in_, uint32_t * out_, const std::size_t n_ ) {
+
+		mix < uint32_t, 0x119de1f3 > ( in_, out_, n_ );
+	}
+
+
+	void hash ( const uint64_t * in_, uint64_t * out_, const std::size_t n_ ) {
+
+		mix < uint64_t, 0x0CF3FD1B9997F637 > ( in_, out_, n_ );
+	}
+
+
+	void unHash ( const uint64_t * in_, uint64_t * out_, const std::size_t n_ ) {
+
+		mix < uint64_t, 0xAFC1530680179F87 > ( in_, out_, n_ );
+	}
+
+
+	const char * hashKernelName ( ) {
+
+		static const char * names [ ] = { "scalar", "avx2", "avx512" };
+
+		return names [ int ( hashKernel ( ) ) ];
+	}
+
+
 	// Random...
 
 	// Seeding, from Intel Broadwell CPU onwards...
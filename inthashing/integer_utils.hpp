@@ -7,6 +7,7 @@
 
 #include <immintrin.h>
 #include <cstdint>
+#include <cstddef>
 
 #include <type_traits>
 
@@ -194,8 +195,22 @@ namespace jimi {
 	}
 
 
+	// 128-bit unsigned, where the compiler has it (gcc, clang, clang-cl, not
+	// cl). The type traits of the standard library don't admit it (with
+	// -std=c++17), the templates above don't take it...
+
+#ifdef __SIZEOF_INT128__
+#define JIMI_HAS_UINT128 1
+
+	using uint128_t = unsigned __int128;
+#endif
+
+
 	uint32_t modularMultiplicativeInverse ( const uint32_t a_ );
 	uint64_t modularMultiplicativeInverse ( const uint64_t a_ );
+#ifdef JIMI_HAS_UINT128
+	uint128_t modularMultiplicativeInverse ( const uint128_t a_ );
+#endif
 
 
 	bool isPrime ( const uint32_t n_ ); // Odd only...
@@ -245,10 +260,136 @@ namespace jimi {
 	}
 
 
+#ifdef JIMI_HAS_UINT128
+
+	// 0xDD60C8D680195D76B9465B15AA5D3A11 0x902B9E0B50D7BFFF39E09CB89170F6F1 - 0.0019363332
+	//
+	// The 128 x 128 bit multiplies keep the low half only, one 64 x 64 -> 128
+	// bit mul (mul128 ( ), as in mulmod64.h) and two 64-bit imuls each. The
+	// constants can't be literals, they're put together from their halves...
+
+	inline uint128_t hash ( uint128_t x ) {
+
+		constexpr uint128_t m = ( uint128_t ( 0xDD60C8D680195D76 ) << 64 ) | 0xB9465B15AA5D3A11;
+
+		x = ( ( x >> 64 ) ^ x ) * m;
+		x = ( ( x >> 64 ) ^ x ) * m;
+		x = ( ( x >> 64 ) ^ x );
+
+		return x;
+	}
+
+
+	inline uint128_t unHash ( uint128_t x ) {
+
+		constexpr uint128_t m = ( uint128_t ( 0x902B9E0B50D7BFFF ) << 64 ) | 0x39E09CB89170F6F1;
+
+		x = ( ( x >> 64 ) ^ x ) * m;
+		x = ( ( x >> 64 ) ^ x ) * m;
+		x = ( ( x >> 64 ) ^ x );
+
+		return x;
+	}
+
+#endif
+
+
+	// Keyed Integer Hashing, a key per table (jimi::seed ( ) draws one), so
+	// that keys crafted to collide under the public constants don't collide
+	// in that table. The key is added after the first multiply, it moves
+	// every input through the second xorshift (the non linear step) by a
+	// different amount, for one add more than hash ( ). Keyed, not
+	// cryptographic: outputs that leak give the key away, against those
+	// only a keyed PRF (SipHash) holds. unHash ( x, key ) undoes it, with
+	// the same key. A key of 0 is hash ( ) and unHash ( )...
+
+	inline uint32_t hash ( uint32_t x, const uint32_t key_ ) {
+
+		x = ( ( x >> 16 ) ^ x ) * 0x45d9f3b + key_;
+		x = ( ( x >> 16 ) ^ x ) * 0x45d9f3b;
+		x = ( ( x >> 16 ) ^ x );
+
+		return x;
+	}
+
+
+	inline uint32_t unHash ( uint32_t x, const uint32_t key_ ) {
+
+		x = ( ( x >> 16 ) ^ x ) * 0x119de1f3;
+		x = ( ( ( x >> 16 ) ^ x ) - key_ ) * 0x119de1f3;
+		x = ( ( x >> 16 ) ^ x );
+
+		return x;
+	}
+
+
+	inline uint64_t hash ( uint64_t x, const uint64_t key_ ) {
+
+		x = ( ( x >> 32 ) ^ x ) * 0x0CF3FD1B9997F637 + key_;
+		x = ( ( x >> 32 ) ^ x ) * 0x0CF3FD1B9997F637;
+		x = ( ( x >> 32 ) ^ x );
+
+		return x;
+	}
+
+
+	inline uint64_t unHash ( uint64_t x, const uint64_t key_ ) {
+
+		x = ( ( x >> 32 ) ^ x ) * 0xAFC1530680179F87;
+		x = ( ( ( x >> 32 ) ^ x ) - key_ ) * 0xAFC1530680179F87;
+		x = ( ( x >> 32 ) ^ x );
+
+		return x;
+	}
+
+#ifdef JIMI_HAS_UINT128
+
+	inline uint128_t hash ( uint128_t x, const uint128_t key_ ) {
+
+		constexpr uint128_t m = ( uint128_t ( 0xDD60C8D680195D76 ) << 64 ) | 0xB9465B15AA5D3A11;
+
+		x = ( ( x >> 64 ) ^ x ) * m + key_;
+		x = ( ( x >> 64 ) ^ x ) * m;
+		x = ( ( x >> 64 ) ^ x );
+
+		return x;
+	}
+
+
+	inline uint128_t unHash ( uint128_t x, const uint128_t key_ ) {
+
+		constexpr uint128_t m = ( uint128_t ( 0x902B9E0B50D7BFFF ) << 64 ) | 0x39E09CB89170F6F1;
+
+		x = ( ( x >> 64 ) ^ x ) * m;
+		x = ( ( ( x >> 64 ) ^ x ) - key_ ) * m;
+		x = ( ( x >> 64 ) ^ x );
+
+		return x;
+	}
+
+#endif
+
+
+	// Integer Hashing, in bulk: out_ [ i ] = hash ( in_ [ i ] ), in place if
+	// in_ == out_. The kernel, AVX-512, AVX2 or scalar, is picked at runtime
+	// on the first call, from what the CPU (and the OS) supports...
+
+	void hash ( const uint32_t * in_, uint32_t * out_, const std::size_t n_ );
+	void unHash ( const uint32_t * in_, uint32_t * out_, const std::size_t n_ );
+
+	void hash ( const uint64_t * in_, uint64_t * out_, const std::size_t n_ );
+	void unHash ( const uint64_t * in_, uint64_t * out_, const std::size_t n_ );
+
+	const char * hashKernelName ( ); // "avx512", "avx2" or "scalar"
+
+
 	uint32_t popCount ( const uint8_t x_ );
 	uint32_t popCount ( const uint16_t x_ );
 	uint32_t popCount ( const uint32_t x_ );
 	uint32_t popCount ( const uint64_t x_ );
+#ifdef JIMI_HAS_UINT128
+	uint32_t popCount ( const uint128_t x_ );
+#endif
 
 
 	template < typename T, typename = std::enable_if_t < std::is_integral < T >::value, T > >
@@ -343,6 +484,20 @@ namespace jimi {
 		// non-overlapping subsequences for parallel computations.
 
 		void jump ( ) const;
+
+		// The raw state, for saving and restoring a generator...
+
+		void getState ( uint64_t & s0_, uint64_t & s1_ ) const {
+
+			s0_ = m_s0;
+			s1_ = m_s1;
+		}
+
+		void setState ( const uint64_t s0_, const uint64_t s1_ ) {
+
+			m_s0 = s0_;
+			m_s1 = s1_;
+		}
 	};
 
 #ifdef __AVX2__
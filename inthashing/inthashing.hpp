@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+
+#include <type_traits>
+
+
+namespace inthashing {
+
+	// The 8- and 16-bit operands would promote to (a signed) int, and their
+	// products overflow it, the multiplies are done at least unsigned int
+	// wide, as in mixer_composition.hpp...
+
+	template<typename T>
+	using unsigned_promoted = std::conditional_t<( sizeof ( T ) < sizeof ( unsigned ) ), unsigned, T>;
+
+	// Half the width is sizeof ( T ) * 4, also at 8 bits, where
+	// ( sizeof ( T ) / 2 ) * 8 is 0, which turned x ^ ( x >> s ) into 0...
+
+	template<typename T>
+	T hash ( T x_, const T m_ ) {
+
+		using W = unsigned_promoted<T>;
+
+		x_ = T ( W ( ( x_ >> ( sizeof ( T ) * 4 ) ) ^ x_ ) * W ( m_ ) );
+		x_ = T ( W ( ( x_ >> ( sizeof ( T ) * 4 ) ) ^ x_ ) * W ( m_ ) );
+		//x_ = ( ( x_ >> ( sizeof ( T ) * 4 ) ) ^ x_ ) * m_;
+
+		return T ( ( x_ >> ( sizeof ( T ) * 4 ) ) ^ x_ );
+	}
+
+	template<typename T>
+	T mul_m ( T x_, const T m_ ) {
+
+		return T ( unsigned_promoted<T> ( x_ ) * unsigned_promoted<T> ( m_ ) );
+	}
+
+
+	// The xorshift-multiply finalizer family (murmur3 fmix, splitmix), with
+	// the shifts as template parameters, so they stay immediates:
+	//
+	//     x = ( x ^ ( x >> S1 ) ) * m [ 0 ];
+	//     x = ( x ^ ( x >> S2 ) ) * m [ 1 ];
+	//     x = ( x ^ ( x >> S2 ) ) * m [ 0 ]; // Rounds == 3 only
+	//     x = ( x ^ ( x >> S3 ) );
+	//
+	// mixer<T, w / 2, w / 2, w / 2, 2> with m [ 0 ] == m [ 1 ] is hash ( ) above...
+
+	template<typename T, std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+	struct mixer {
+
+		static_assert ( Rounds == 2 or Rounds == 3, "mixer: 2 or 3 rounds" );
+
+		using value_type = T;
+
+		static constexpr std::uint32_t shift1 = S1, shift2 = S2, shift3 = S3, rounds = Rounds;
+
+		T m [ 2 ];
+
+		T operator ( ) ( T x_ ) const noexcept {
+
+			using W = unsigned_promoted<T>;
+
+			x_ = T ( W ( ( x_ >> S1 ) ^ x_ ) * W ( m [ 0 ] ) );
+			x_ = T ( W ( ( x_ >> S2 ) ^ x_ ) * W ( m [ 1 ] ) );
+
+			if ( Rounds == 3 ) {
+
+				x_ = T ( W ( ( x_ >> S2 ) ^ x_ ) * W ( m [ 0 ] ) );
+			}
+
+			return T ( ( x_ >> S3 ) ^ x_ );
+		}
+	};
+
+	template<typename T>
+	using classic_mixer = mixer<T, sizeof ( T ) * 4, sizeof ( T ) * 4, sizeof ( T ) * 4, 2>;
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+// Input models for the scorers. Every key_source is a small state machine
+// that produces its keys in batches; one per thread and distribution...
+
+enum class key_distribution : std::uint32_t {
+
+	uniform,	// uniform random
+	counter,	// consecutive values from a random start, database ids
+	strided,	// a random start, then steps of a power of two, aligned addresses, timestamps
+	sparse,		// 1 to 4 random bits set, bitsets, flags
+	gray,		// a Gray code walk from a random start, every key one bit away from the previous one
+	replay,		// keys from a file, see key_replay
+	count
+};
+
+inline const char * keyDistributionName ( const key_distribution d_ ) noexcept {
+
+	static const char * names [ ] = { "uniform", "counter", "strided", "sparse", "gray", "replay" };
+
+	return d_ < key_distribution::count ? names [ std::uint32_t ( d_ ) ] : "unknown";
+}
+
+
+// A binary file of native endian keys of type T, mapped read only, shared
+// by all threads...
+
+template<typename T>
+class key_replay {
+
+	boost::interprocess::file_mapping m_file;
+	boost::interprocess::mapped_region m_region;
+
+public:
+
+	// Throws boost::interprocess::interprocess_exception if the file can not be mapped...
+
+	explicit key_replay ( const std::string & path_ ) :
+
+		m_file ( path_.c_str ( ), boost::interprocess::read_only ), m_region ( m_file, boost::interprocess::read_only ) {
+
+		m_region.advise ( boost::interprocess::mapped_region::advice_sequential );
+	}
+
+	const T * data ( ) const noexcept {
+
+		return ( const T * ) m_region.get_address ( );
+	}
+
+	std::size_t size ( ) const noexcept {
+
+		return m_region.get_size ( ) / sizeof ( T );
+	}
+};
+
+
+template<typename T>
+class key_source {
+
+	key_distribution m_distribution;
+
+	T m_next = 0, m_stride = 1;
+	std::size_t m_position = 0;
+
+	const key_replay<T> * m_replay = nullptr;
+
+	// A draw of the full width, two of them at 128 bits...
+
+	template<typename Engine>
+	static T draw ( Engine & rng_ ) {
+
+		if constexpr ( sizeof ( T ) > sizeof ( std::uint64_t ) ) {
+
+			const T high = T ( rng_ ( ) );
+
+			return T ( ( high << 64 ) | T ( rng_ ( ) ) );
+		}
+
+		else {
+
+			return T ( rng_ ( ) );
+		}
+	}
+
+public:
+
+	// The replay source walks the file from a random position, wrapping
+	// around at the end...
+
+	template<typename Engine>
+	key_source ( const key_distribution d_, Engine & rng_, const key_replay<T> * replay_ = nullptr ) : m_distribution ( d_ ), m_replay ( replay_ ) {
+
+		m_next = draw ( rng_ );
+		m_stride = T ( T ( 1 ) << ( 1 + rng_ ( ) % ( sizeof ( T ) * 2 ) ) );
+
+		if ( m_replay and m_replay->size ( ) ) {
+
+			m_position = std::size_t ( rng_ ( ) % m_replay->size ( ) );
+		}
+	}
+
+	key_distribution distribution ( ) const noexcept {
+
+		return m_distribution;
+	}
+
+	// Returns n_ keys, in buffer_ or, zero copy, straight from the replay
+	// file, if they are contiguous in it...
+
+	template<typename Engine>
+	const T * next ( Engine & rng_, T * buffer_, const std::size_t n_ ) {
+
+		switch ( m_distribution ) {
+
+			case key_distribution::counter:
+
+				for ( std::size_t i = 0; i < n_; ++i ) {
+
+					buffer_ [ i ] = ++m_next;
+				}
+
+				break;
+
+			case key_distribution::strided:
+
+				for ( std::size_t i = 0; i < n_; ++i ) {
+
+					buffer_ [ i ] = m_next += m_stride;
+				}
+
+				break;
+
+			case key_distribution::sparse:
+
+				for ( std::size_t i = 0; i < n_; ++i ) {
+
+					std::uint64_t r = rng_ ( );
+					T x = 0;
+
+					for ( std::uint32_t k = 1 + std::uint32_t ( r & 3 ); k; --k ) {
+
+						r >>= 8;
+						x |= T ( T ( 1 ) << ( r % ( sizeof ( T ) * 8 ) ) );
+					}
+
+					buffer_ [ i ] = x;
+				}
+
+				break;
+
+			case key_distribution::gray:
+
+				// jimi::decimalToGray ( ), written out, its enable_if doesn't take 128 bits...
+
+				for ( std::size_t i = 0; i < n_; ++i ) {
+
+					++m_next;
+
+					buffer_ [ i ] = T ( m_next ^ ( m_next >> 1 ) );
+				}
+
+				break;
+
+			case key_distribution::replay:
+
+				if ( m_replay and m_replay->size ( ) ) {
+
+					if ( m_position + n_ <= m_replay->size ( ) ) {
+
+						const T * keys = m_replay->data ( ) + m_position;
+
+						m_position = ( m_position + n_ ) % m_replay->size ( );
+
+						return keys;
+					}
+
+					for ( std::size_t i = 0; i < n_; ++i ) {
+
+						buffer_ [ i ] = m_replay->data ( ) [ m_position ];
+						m_position = ( m_position + 1 ) % m_replay->size ( );
+					}
+
+					break;
+				}
+
+				// No file...
+
+				[[fallthrough]];
+
+			default:
+
+				for ( std::size_t i = 0; i < n_; ++i ) {
+
+					buffer_ [ i ] = draw ( rng_ );
+				}
+
+				break;
+		}
+
+		return buffer_;
+	}
+};
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <type_traits>
+
+
+// Hashers composed at compile time from a list of invertible steps, the
+// inverse hasher is derived from the list, nothing is worked out by hand:
+//
+//     using h = composition<std::uint64_t, xorshift_right<std::uint64_t, 29>, multiply<std::uint64_t, 0x0CF3FD1B9997F637>, xorshift_right<std::uint64_t, 32>>;
+//
+//     h::apply ( x ), h::inverse::apply ( h::apply ( x ) ) == x
+//
+// The steps are xorshift right by K, multiply by an odd M, rotate left by K
+// and add C. A xorshift by less than half the width is undone by iterating
+// the shift, the inverse of M follows from modularInverse ( ) below...
+
+namespace inthashing {
+
+	// The inverse of odd a_ mod 2^w, constexpr. Newton, every step doubles
+	// the correct low bits, a_ is its own inverse to 3 bits. The arithmetic
+	// is at least unsigned int wide, so the narrow types don't overflow into
+	// a signed int...
+
+	template<typename T>
+	constexpr T modularInverse ( const T a_ ) noexcept {
+
+		using W = std::conditional_t<( sizeof ( T ) < sizeof ( unsigned ) ), unsigned, T>;
+
+		W x = W ( a_ );
+
+		for ( std::uint32_t bits = 3; bits < sizeof ( T ) * 8; bits *= 2 ) {
+
+			x = W ( x * W ( W ( 2 ) - W ( W ( a_ ) * x ) ) );
+		}
+
+		return T ( x );
+	}
+
+
+	template<typename T, std::uint32_t K>
+	struct xorshift_right_inverse;
+
+	// x ^ ( x >> K )...
+
+	template<typename T, std::uint32_t K>
+	struct xorshift_right {
+
+		static_assert ( K > 0 and K < sizeof ( T ) * 8, "xorshift_right: 0 < K < w" );
+
+		static constexpr T apply ( const T x_ ) noexcept {
+
+			return T ( x_ ^ ( x_ >> K ) );
+		}
+
+		using inverse = xorshift_right_inverse<T, K>;
+	};
+
+	// The top K bits of y = x ^ ( x >> K ) are those of x, every iteration
+	// recovers the next K, ceil ( w / K ) - 1 iterations in all, one for
+	// K >= w / 2...
+
+	template<typename T, std::uint32_t K>
+	struct xorshift_right_inverse {
+
+		static constexpr T apply ( const T y_ ) noexcept {
+
+			T x = y_;
+
+			for ( std::uint32_t s = K; s < sizeof ( T ) * 8; s += K ) {
+
+				x = T ( y_ ^ ( x >> K ) );
+			}
+
+			return x;
+		}
+
+		using inverse = xorshift_right<T, K>;
+	};
+
+	// x * M, M odd...
+
+	template<typename T, T M>
+	struct multiply {
+
+		static_assert ( M & T ( 1 ), "multiply: M must be odd" );
+
+		static constexpr T apply ( const T x_ ) noexcept {
+
+			using W = std::conditional_t<( sizeof ( T ) < sizeof ( unsigned ) ), unsigned, T>;
+
+			return T ( W ( x_ ) * W ( M ) );
+		}
+
+		using inverse = multiply<T, modularInverse ( M )>;
+	};
+
+	// Rotate left by K...
+
+	template<typename T, std::uint32_t K>
+	struct rotate_left {
+
+		static_assert ( K > 0 and K < sizeof ( T ) * 8, "rotate_left: 0 < K < w" );
+
+		static constexpr T apply ( const T x_ ) noexcept {
+
+			return T ( T ( x_ << K ) | T ( x_ >> ( sizeof ( T ) * 8 - K ) ) );
+		}
+
+		using inverse = rotate_left<T, std::uint32_t ( sizeof ( T ) * 8 - K )>;
+	};
+
+	// x + C...
+
+	template<typename T, T C>
+	struct add {
+
+		static constexpr T apply ( const T x_ ) noexcept {
+
+			return T ( x_ + C );
+		}
+
+		using inverse = add<T, T ( T ( 0 ) - C )>;
+	};
+
+
+	template<typename T, typename ... Steps>
+	struct composition;
+
+	namespace detail {
+
+		// The inverses of the steps, in reverse order...
+
+		template<typename Done, typename ... Rest>
+		struct invert_steps;
+
+		template<typename T, typename ... Done>
+		struct invert_steps<composition<T, Done ...>> {
+
+			using type = composition<T, Done ...>;
+		};
+
+		template<typename T, typename ... Done, typename S, typename ... Rest>
+		struct invert_steps<composition<T, Done ...>, S, Rest ...> {
+
+			using type = typename invert_steps<composition<T, typename S::inverse, Done ...>, Rest ...>::type;
+		};
+	}
+
+	// The steps, first to last. Everything is static and constexpr, a
+	// composition compiles to the steps inline, as if written by hand...
+
+	template<typename T, typename ... Steps>
+	struct composition {
+
+		static_assert ( T ( 0 ) < T ( ~T ( 0 ) ), "composition: unsigned types only" ); // std::is_unsigned doesn't know 128 bits
+
+		using value_type = T;
+		using inverse = typename detail::invert_steps<composition<T>, Steps ...>::type;
+
+		static constexpr T apply ( T x_ ) noexcept {
+
+			( ( x_ = Steps::apply ( x_ ) ), ... );
+
+			return x_;
+		}
+
+		constexpr T operator ( ) ( const T x_ ) const noexcept {
+
+			return apply ( x_ );
+		}
+
+		static constexpr T unapply ( const T x_ ) noexcept {
+
+			return inverse::apply ( x_ );
+		}
+	};
+
+
+	// The searched form, see mixer in inthashing.hpp, as a composition, so
+	// a multiplier (pair) the search reports becomes a hash / unhash pair:
+	//
+	//     using h = xorshift_multiply<std::uint64_t, 32, 32, 32, 0x0CF3FD1B9997F637>;
+	//
+	// Rounds == 3 has a third multiply, by M1, after a third xorshift by S2...
+
+	template<typename T, std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, T M1, T M2 = M1, std::uint32_t Rounds = 2>
+	using xorshift_multiply = std::conditional_t<Rounds == 2,
+		composition<T, xorshift_right<T, S1>, multiply<T, M1>, xorshift_right<T, S2>, multiply<T, M2>, xorshift_right<T, S3>>,
+		composition<T, xorshift_right<T, S1>, multiply<T, M1>, xorshift_right<T, S2>, multiply<T, M2>, xorshift_right<T, S2>, multiply<T, M1>, xorshift_right<T, S3>>>;
+
+
+	// jimi::hash ( ) and the hand derived inverse constants of jimi::unHash ( )...
+
+	static_assert ( modularInverse<std::uint32_t> ( 0x45d9f3b ) == 0x119de1f3, "modularInverse: 32-bit" );
+	static_assert ( modularInverse<std::uint64_t> ( 0x0CF3FD1B9997F637 ) == 0xAFC1530680179F87, "modularInverse: 64-bit" );
+
+#ifdef __SIZEOF_INT128__
+	static_assert ( modularInverse<unsigned __int128> ( ( ( unsigned __int128 ) 0xDD60C8D680195D76 << 64 ) | 0xB9465B15AA5D3A11 ) == ( ( ( unsigned __int128 ) 0x902B9E0B50D7BFFF << 64 ) | 0x39E09CB89170F6F1 ), "modularInverse: 128-bit" );
+#endif
+
+	static_assert ( xorshift_multiply<std::uint64_t, 29, 31, 17, 0x0CF3FD1B9997F637, 0xDBBF59B09980D163, 3>::unapply (
+		xorshift_multiply<std::uint64_t, 29, 31, 17, 0x0CF3FD1B9997F637, 0xDBBF59B09980D163, 3>::apply ( 0x0123456789ABCDEF ) ) == 0x0123456789ABCDEF, "composition: inverse" );
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#include <array>
+
+
+// Counts of the popcounts of output differences, bin k holds the samples in
+// which k output bits flipped. Everything the Ksac scorers report follows
+// from the bins, so the hot loop is an increment, histograms add up exactly
+// (across threads, across checkpoints) and the result doesn't depend on the
+// order the samples came in...
+
+template<typename T>
+class popcount_histogram {
+
+public:
+
+	static constexpr std::uint32_t bits = sizeof ( T ) * 8, size = bits + 1;
+
+private:
+
+	std::array<std::uint64_t, size> m_bins = { };
+
+public:
+
+	void add ( const std::uint32_t popcount_ ) noexcept {
+
+		++m_bins [ popcount_ ];
+	}
+
+	std::uint64_t * bins ( ) noexcept {
+
+		return m_bins.data ( );
+	}
+
+	const std::uint64_t * bins ( ) const noexcept {
+
+		return m_bins.data ( );
+	}
+
+	popcount_histogram & operator += ( const popcount_histogram & rhs_ ) noexcept {
+
+		for ( std::uint32_t k = 0; k < size; ++k ) {
+
+			m_bins [ k ] += rhs_.m_bins [ k ];
+		}
+
+		return *this;
+	}
+
+	void clear ( ) noexcept {
+
+		m_bins.fill ( 0 );
+	}
+
+	std::uint64_t samples ( ) const noexcept {
+
+		std::uint64_t n = 0;
+
+		for ( const std::uint64_t c : m_bins ) {
+
+			n += c;
+		}
+
+		return n;
+	}
+
+	// Sum over the samples of ( popcount - w / 2 )^2, exact...
+
+	std::uint64_t squared_deviation ( ) const noexcept {
+
+		std::uint64_t sum = 0;
+
+		for ( std::uint32_t k = 0; k < size; ++k ) {
+
+			const std::int64_t d = std::int64_t ( k ) - std::int64_t ( bits / 2 );
+
+			sum += m_bins [ k ] * std::uint64_t ( d * d );
+		}
+
+		return sum;
+	}
+
+	// Mean of the per sample error e = ( popcount / w - 1 / 2 )^2, the Ksac MSR...
+
+	double msr ( ) const noexcept {
+
+		const std::uint64_t n = samples ( );
+
+		return n ? double ( squared_deviation ( ) ) / ( double ( n ) * double ( bits ) * double ( bits ) ) : 0.0;
+	}
+
+	// Variance of e, and the standard error of msr ( )...
+
+	double variance ( ) const noexcept {
+
+		const std::uint64_t n = samples ( );
+
+		if ( n < 2 ) {
+
+			return 0.0;
+		}
+
+		const double mean = msr ( );
+
+		double sum = 0.0;
+
+		for ( std::uint32_t k = 0; k < size; ++k ) {
+
+			const double d = double ( k ) / double ( bits ) - 0.5, e = d * d - mean;
+
+			sum += double ( m_bins [ k ] ) * e * e;
+		}
+
+		return sum / double ( n - 1 );
+	}
+
+	double standard_error ( ) const noexcept {
+
+		const std::uint64_t n = samples ( );
+
+		return n ? std::sqrt ( variance ( ) / double ( n ) ) : 0.0;
+	}
+};
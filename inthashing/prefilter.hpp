@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <vector>
+
+
+// Structural features of a multiplier, all cheap, for rejecting candidates
+// before any hashing is done: extreme popcounts, long runs of equal bits,
+// a lopsided half, and a short multiplicative order. The order of an odd m
+// mod 2^w is a power of two, 2^k with k <= w - 2; k is found by squaring,
+// m^( 2^k ) == 1, in at most w - 2 multiplications...
+
+namespace inthashing {
+
+	struct multiplier_features {
+
+		std::uint32_t popcount, longest_run, low_popcount, high_popcount, order_log2;
+	};
+
+	template<typename T>
+	std::uint32_t multiplicativeOrderLog2 ( const T m_ ) noexcept {
+
+		std::uint32_t k = 0;
+
+		for ( T x = m_; x != T ( 1 ) and k < sizeof ( T ) * 8; x = T ( x * x ) ) {
+
+			++k;
+		}
+
+		return k;
+	}
+
+	template<typename T>
+	multiplier_features getMultiplierFeatures ( const T m_ ) noexcept {
+
+		constexpr std::uint32_t bits = sizeof ( T ) * 8, half = bits / 2;
+
+		multiplier_features f { 0, 0, 0, 0, multiplicativeOrderLog2 ( m_ ) };
+
+		std::uint32_t run = 0;
+
+		for ( std::uint32_t i = 0; i < bits; ++i ) {
+
+			const std::uint32_t b = std::uint32_t ( m_ >> i ) & 1;
+
+			f.popcount += b;
+			( i < half ? f.low_popcount : f.high_popcount ) += b;
+
+			run = i and b == ( std::uint32_t ( m_ >> ( i - 1 ) ) & 1 ) ? run + 1 : 1;
+			f.longest_run = std::max ( f.longest_run, run );
+		}
+
+		return f;
+	}
+
+
+	// The accepted region, inclusive bounds...
+
+	struct prefilter_thresholds {
+
+		std::uint32_t min_popcount, max_popcount, max_run, min_half_popcount, max_half_popcount, min_order_log2;
+
+		bool passes ( const multiplier_features & f_ ) const noexcept {
+
+			return f_.popcount >= min_popcount and f_.popcount <= max_popcount and f_.longest_run <= max_run and
+				std::min ( f_.low_popcount, f_.high_popcount ) >= min_half_popcount and std::max ( f_.low_popcount, f_.high_popcount ) <= max_half_popcount and
+				f_.order_log2 >= min_order_log2;
+		}
+
+		// Widens the region to include f_...
+
+		void include ( const multiplier_features & f_ ) noexcept {
+
+			min_popcount = std::min ( min_popcount, f_.popcount );
+			max_popcount = std::max ( max_popcount, f_.popcount );
+			max_run = std::max ( max_run, f_.longest_run );
+			min_half_popcount = std::min ( min_half_popcount, std::min ( f_.low_popcount, f_.high_popcount ) );
+			max_half_popcount = std::max ( max_half_popcount, std::max ( f_.low_popcount, f_.high_popcount ) );
+			min_order_log2 = std::min ( min_order_log2, f_.order_log2 );
+		}
+	};
+
+	namespace detail {
+
+		// The least bound v (or, from the top, the greatest) such that the
+		// values below (above) it add up to at most cut_ of the counts of
+		// histogram_...
+
+		inline std::uint32_t lowerBound ( const std::vector<std::uint64_t> & histogram_, const std::uint64_t cut_ ) noexcept {
+
+			std::uint32_t v = 0;
+
+			for ( std::uint64_t below = 0; v + 1 < histogram_.size ( ) and below + histogram_ [ v ] <= cut_; ++v ) {
+
+				below += histogram_ [ v ];
+			}
+
+			return v;
+		}
+
+		inline std::uint32_t upperBound ( const std::vector<std::uint64_t> & histogram_, const std::uint64_t cut_ ) noexcept {
+
+			std::uint32_t v = std::uint32_t ( histogram_.size ( ) - 1 );
+
+			for ( std::uint64_t above = 0; v and above + histogram_ [ v ] <= cut_; --v ) {
+
+				above += histogram_ [ v ];
+			}
+
+			return v;
+		}
+	}
+
+	// Conservative defaults, for when there are no scores to learn from yet.
+	// They follow from the distribution of the features over the odd
+	// multipliers of the width, all of them up to 16 bits, a fixed sample of
+	// 2^16 above: every bound cuts off at most default_tail of them, so at
+	// least 1 - 6 * default_tail (97%, about 98% as measured) pass, at any
+	// width, at 8 bits every multiplier does, one of them is over the tail.
+	// Fixed fractions of the width don't do that, runs <= bits / 4 alone
+	// rejects most 8-bit multipliers and next to none at 64 bits...
+
+	constexpr double default_tail = 0.005;
+
+	template<typename T>
+	prefilter_thresholds defaultPrefilter ( ) {
+
+		static const prefilter_thresholds thresholds = [ ] ( ) {
+
+			constexpr std::uint32_t bits = sizeof ( T ) * 8;
+
+			std::vector<std::uint64_t> popcount ( bits + 1, 0 ), run ( bits + 1, 0 ), low_half ( bits + 1, 0 ), high_half ( bits + 1, 0 ), order ( bits + 1, 0 );
+			std::uint64_t n = 0;
+
+			const auto add = [ & ] ( const T m_ ) {
+
+				const multiplier_features f = getMultiplierFeatures ( m_ );
+
+				++popcount [ f.popcount ];
+				++run [ f.longest_run ];
+				++low_half [ std::min ( f.low_popcount, f.high_popcount ) ];
+				++high_half [ std::max ( f.low_popcount, f.high_popcount ) ];
+				++order [ f.order_log2 ];
+				++n;
+			};
+
+			if constexpr ( bits <= 16 ) {
+
+				for ( std::uint32_t m = 1; m < ( 1u << bits ); m += 2 ) {
+
+					add ( T ( m ) );
+				}
+			}
+
+			else {
+
+				std::uint64_t state = 0x9E3779B97F4A7C15; // splitmix64, the sample is the same every run
+
+				const auto next = [ & state ] ( ) noexcept {
+
+					std::uint64_t z = ( state += 0x9E3779B97F4A7C15 );
+
+					z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9;
+					z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EB;
+
+					return z ^ ( z >> 31 );
+				};
+
+				for ( std::uint32_t i = 0; i < ( 1u << 16 ); ++i ) {
+
+					if constexpr ( bits > 64 ) {
+
+						const T high = T ( next ( ) );
+
+						add ( T ( ( high << 64 ) | T ( next ( ) ) | T ( 1 ) ) );
+					}
+
+					else {
+
+						add ( T ( T ( next ( ) ) | T ( 1 ) ) );
+					}
+				}
+			}
+
+			const std::uint64_t cut = std::uint64_t ( default_tail * double ( n ) );
+
+			return prefilter_thresholds { detail::lowerBound ( popcount, cut ), detail::upperBound ( popcount, cut ), detail::upperBound ( run, cut ),
+				detail::lowerBound ( low_half, cut ), detail::upperBound ( high_half, cut ), detail::lowerBound ( order, cut ) };
+		} ( );
+
+		return thresholds;
+	}
+
+	// The empty region, to be widened by include ( )...
+
+	template<typename T>
+	constexpr prefilter_thresholds emptyPrefilter ( ) noexcept {
+
+		constexpr std::uint32_t bits = sizeof ( T ) * 8;
+
+		return { bits, 0, 0, bits, 0, bits };
+	}
+}
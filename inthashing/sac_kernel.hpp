@@ -0,0 +1,426 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <immintrin.h>
+
+#include "inthashing.hpp"
+
+
+// Vectorized strict avalanche kernel for the 64-bit inthashing::mixer's, 4
+// lanes (AVX2) or 8 lanes (AVX-512DQ/BW) per iteration. The hot loop stays
+// in integer registers, the caller divides once at the end. Other widths,
+// up to 128 bits, take the scalar path...
+
+namespace inthashing {
+
+	namespace detail {
+
+		// The popcount of any width, 128 bits as two halves...
+
+		template<typename T>
+		std::uint32_t popcnt ( const T x_ ) noexcept {
+
+			if constexpr ( sizeof ( T ) > 8 ) {
+
+				return std::uint32_t ( _mm_popcnt_u64 ( std::uint64_t ( x_ ) ) + _mm_popcnt_u64 ( std::uint64_t ( x_ >> 64 ) ) );
+			}
+
+			else {
+
+				return std::uint32_t ( _mm_popcnt_u64 ( std::uint64_t ( x_ ) ) );
+			}
+		}
+
+		template<typename H>
+		std::uint64_t sacSquaredDeviation ( const H & h_, const typename H::value_type x_, const typename H::value_type y_ ) noexcept {
+
+			using T = typename H::value_type;
+
+			const std::int64_t d = std::int64_t ( popcnt ( T ( h_ ( x_ ) ^ h_ ( y_ ) ) ) ) - std::int64_t ( sizeof ( T ) * 4 );
+
+			return std::uint64_t ( d * d );
+		}
+
+#ifdef __AVX2__
+
+		// Low 64 bits of a 64 x 64 bit multiply, from three 32 x 32 -> 64 bit
+		// multiplies, m_hi_ holds the high halves of m_ in the low halves...
+
+		inline __m256i mullo_epi64 ( const __m256i x_, const __m256i m_, const __m256i m_hi_ ) noexcept {
+
+			const __m256i lo = _mm256_mul_epu32 ( x_, m_ );
+			const __m256i cross = _mm256_add_epi64 ( _mm256_mul_epu32 ( _mm256_srli_epi64 ( x_, 32 ), m_ ), _mm256_mul_epu32 ( x_, m_hi_ ) );
+
+			return _mm256_add_epi64 ( lo, _mm256_slli_epi64 ( cross, 32 ) );
+		}
+
+		template<std::uint32_t S>
+		__m256i xorshift_epi64 ( const __m256i x_ ) noexcept {
+
+			return _mm256_xor_si256 ( _mm256_srli_epi64 ( x_, S ), x_ );
+		}
+
+		template<std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+		struct mixer_epi64 {
+
+			__m256i m0, m0_hi, m1, m1_hi;
+
+			explicit mixer_epi64 ( const mixer<std::uint64_t, S1, S2, S3, Rounds> & h_ ) noexcept :
+
+				m0 ( _mm256_set1_epi64x ( std::int64_t ( h_.m [ 0 ] ) ) ), m0_hi ( _mm256_set1_epi64x ( std::int64_t ( h_.m [ 0 ] >> 32 ) ) ),
+				m1 ( _mm256_set1_epi64x ( std::int64_t ( h_.m [ 1 ] ) ) ), m1_hi ( _mm256_set1_epi64x ( std::int64_t ( h_.m [ 1 ] >> 32 ) ) ) { }
+
+			// Lane j hashes with h_ [ j ]...
+
+			explicit mixer_epi64 ( const mixer<std::uint64_t, S1, S2, S3, Rounds> * h_ ) noexcept :
+
+				m0 ( _mm256_setr_epi64x ( std::int64_t ( h_ [ 0 ].m [ 0 ] ), std::int64_t ( h_ [ 1 ].m [ 0 ] ), std::int64_t ( h_ [ 2 ].m [ 0 ] ), std::int64_t ( h_ [ 3 ].m [ 0 ] ) ) ), m0_hi ( _mm256_srli_epi64 ( m0, 32 ) ),
+				m1 ( _mm256_setr_epi64x ( std::int64_t ( h_ [ 0 ].m [ 1 ] ), std::int64_t ( h_ [ 1 ].m [ 1 ] ), std::int64_t ( h_ [ 2 ].m [ 1 ] ), std::int64_t ( h_ [ 3 ].m [ 1 ] ) ) ), m1_hi ( _mm256_srli_epi64 ( m1, 32 ) ) { }
+
+			__m256i operator ( ) ( __m256i x_ ) const noexcept {
+
+				x_ = mullo_epi64 ( xorshift_epi64<S1> ( x_ ), m0, m0_hi );
+				x_ = mullo_epi64 ( xorshift_epi64<S2> ( x_ ), m1, m1_hi );
+
+				if ( Rounds == 3 ) {
+
+					x_ = mullo_epi64 ( xorshift_epi64<S2> ( x_ ), m0, m0_hi );
+				}
+
+				return xorshift_epi64<S3> ( x_ );
+			}
+		};
+
+		// Nibble lookup popcount, summed per 64-bit lane by vpsadbw...
+
+		inline __m256i popcnt_epi64 ( const __m256i x_ ) noexcept {
+
+			const __m256i lut = _mm256_setr_epi8 ( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+			const __m256i nibble = _mm256_set1_epi8 ( 0x0F );
+
+			const __m256i lo = _mm256_shuffle_epi8 ( lut, _mm256_and_si256 ( x_, nibble ) );
+			const __m256i hi = _mm256_shuffle_epi8 ( lut, _mm256_and_si256 ( _mm256_srli_epi16 ( x_, 4 ), nibble ) );
+
+			return _mm256_sad_epu8 ( _mm256_add_epi8 ( lo, hi ), _mm256_setzero_si256 ( ) );
+		}
+
+		inline std::uint64_t horizontal_add_epi64 ( const __m256i x_ ) noexcept {
+
+			const __m128i s = _mm_add_epi64 ( _mm256_castsi256_si128 ( x_ ), _mm256_extracti128_si256 ( x_, 1 ) );
+
+			return std::uint64_t ( _mm_cvtsi128_si64 ( s ) ) + std::uint64_t ( _mm_extract_epi64 ( s, 1 ) );
+		}
+
+#endif
+
+#if defined ( __AVX512DQ__ ) and defined ( __AVX512BW__ )
+
+		template<std::uint32_t S>
+		__m512i xorshift_epi64 ( const __m512i x_ ) noexcept {
+
+			return _mm512_xor_si512 ( _mm512_srli_epi64 ( x_, S ), x_ );
+		}
+
+		template<std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+		struct mixer_epi64x8 {
+
+			__m512i m0, m1;
+
+			explicit mixer_epi64x8 ( const mixer<std::uint64_t, S1, S2, S3, Rounds> & h_ ) noexcept :
+
+				m0 ( _mm512_set1_epi64 ( std::int64_t ( h_.m [ 0 ] ) ) ), m1 ( _mm512_set1_epi64 ( std::int64_t ( h_.m [ 1 ] ) ) ) { }
+
+			explicit mixer_epi64x8 ( const mixer<std::uint64_t, S1, S2, S3, Rounds> * h_ ) noexcept :
+
+				m0 ( _mm512_setr_epi64 ( std::int64_t ( h_ [ 0 ].m [ 0 ] ), std::int64_t ( h_ [ 1 ].m [ 0 ] ), std::int64_t ( h_ [ 2 ].m [ 0 ] ), std::int64_t ( h_ [ 3 ].m [ 0 ] ), std::int64_t ( h_ [ 4 ].m [ 0 ] ), std::int64_t ( h_ [ 5 ].m [ 0 ] ), std::int64_t ( h_ [ 6 ].m [ 0 ] ), std::int64_t ( h_ [ 7 ].m [ 0 ] ) ) ),
+				m1 ( _mm512_setr_epi64 ( std::int64_t ( h_ [ 0 ].m [ 1 ] ), std::int64_t ( h_ [ 1 ].m [ 1 ] ), std::int64_t ( h_ [ 2 ].m [ 1 ] ), std::int64_t ( h_ [ 3 ].m [ 1 ] ), std::int64_t ( h_ [ 4 ].m [ 1 ] ), std::int64_t ( h_ [ 5 ].m [ 1 ] ), std::int64_t ( h_ [ 6 ].m [ 1 ] ), std::int64_t ( h_ [ 7 ].m [ 1 ] ) ) ) { }
+
+			__m512i operator ( ) ( __m512i x_ ) const noexcept {
+
+				x_ = _mm512_mullo_epi64 ( xorshift_epi64<S1> ( x_ ), m0 );
+				x_ = _mm512_mullo_epi64 ( xorshift_epi64<S2> ( x_ ), m1 );
+
+				if ( Rounds == 3 ) {
+
+					x_ = _mm512_mullo_epi64 ( xorshift_epi64<S2> ( x_ ), m0 );
+				}
+
+				return xorshift_epi64<S3> ( x_ );
+			}
+		};
+
+		inline __m512i popcnt_epi64 ( const __m512i x_ ) noexcept {
+
+#ifdef __AVX512VPOPCNTDQ__
+			return _mm512_popcnt_epi64 ( x_ );
+#else
+			const __m512i lut = _mm512_broadcast_i32x4 ( _mm_setr_epi8 ( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 ) );
+			const __m512i nibble = _mm512_set1_epi8 ( 0x0F );
+
+			const __m512i lo = _mm512_shuffle_epi8 ( lut, _mm512_and_si512 ( x_, nibble ) );
+			const __m512i hi = _mm512_shuffle_epi8 ( lut, _mm512_and_si512 ( _mm512_srli_epi16 ( x_, 4 ), nibble ) );
+
+			return _mm512_sad_epu8 ( _mm512_add_epi8 ( lo, hi ), _mm512_setzero_si512 ( ) );
+#endif
+		}
+
+#endif
+	}
+
+
+	// Returns the sum over i of ( popcount ( h_ ( x_ [ i ] ) ^ h_ ( y_ [ i ] ) ) - w / 2 )^2,
+	// i.e. w^2 * n_ times the mean squared Ksac error of the pairs...
+
+	template<typename H>
+	std::uint64_t sacSquaredDeviation ( const H & h_, const typename H::value_type * x_, const typename H::value_type * y_, const std::size_t n_ ) noexcept {
+
+		std::uint64_t sum = 0;
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			sum += detail::sacSquaredDeviation ( h_, x_ [ i ], y_ [ i ] );
+		}
+
+		return sum;
+	}
+
+	template<std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+	std::uint64_t sacSquaredDeviation ( const mixer<std::uint64_t, S1, S2, S3, Rounds> & h_, const std::uint64_t * x_, const std::uint64_t * y_, const std::size_t n_ ) noexcept {
+
+		std::size_t i = 0;
+		std::uint64_t sum = 0;
+
+#if defined ( __AVX512DQ__ ) and defined ( __AVX512BW__ )
+
+		{
+			const detail::mixer_epi64x8<S1, S2, S3, Rounds> h ( h_ );
+			const __m512i half = _mm512_set1_epi64 ( 32 );
+
+			__m512i acc = _mm512_setzero_si512 ( );
+
+			for ( ; i + 8 <= n_; i += 8 ) {
+
+				const __m512i d = _mm512_sub_epi64 ( detail::popcnt_epi64 ( _mm512_xor_si512 ( h ( _mm512_loadu_si512 ( x_ + i ) ), h ( _mm512_loadu_si512 ( y_ + i ) ) ) ), half );
+
+				acc = _mm512_add_epi64 ( acc, _mm512_mul_epi32 ( d, d ) );
+			}
+
+			sum += std::uint64_t ( _mm512_reduce_add_epi64 ( acc ) );
+		}
+
+#elif defined ( __AVX2__ )
+
+		{
+			const detail::mixer_epi64<S1, S2, S3, Rounds> h ( h_ );
+			const __m256i half = _mm256_set1_epi64x ( 32 );
+
+			__m256i acc = _mm256_setzero_si256 ( );
+
+			for ( ; i + 4 <= n_; i += 4 ) {
+
+				const __m256i d = _mm256_sub_epi64 ( detail::popcnt_epi64 ( _mm256_xor_si256 ( h ( _mm256_loadu_si256 ( ( const __m256i * ) ( x_ + i ) ) ), h ( _mm256_loadu_si256 ( ( const __m256i * ) ( y_ + i ) ) ) ) ), half );
+
+				acc = _mm256_add_epi64 ( acc, _mm256_mul_epi32 ( d, d ) );
+			}
+
+			sum += detail::horizontal_add_epi64 ( acc );
+		}
+
+#endif
+
+		for ( ; i < n_; ++i ) {
+
+			sum += detail::sacSquaredDeviation ( h_, x_ [ i ], y_ [ i ] );
+		}
+
+		return sum;
+	}
+
+
+	// Adds the popcount of h_ ( x_ [ i ] ) ^ h_ ( y_ [ i ] ) of every pair to bins_,
+	// sizeof ( T ) * 8 + 1 of them, see popcount_histogram...
+
+	template<typename H>
+	void popcountHistogram ( const H & h_, const typename H::value_type * x_, const typename H::value_type * y_, const std::size_t n_, std::uint64_t * bins_ ) noexcept {
+
+		using T = typename H::value_type;
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			++bins_ [ detail::popcnt ( T ( h_ ( x_ [ i ] ) ^ h_ ( y_ [ i ] ) ) ) ];
+		}
+	}
+
+	template<std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+	void popcountHistogram ( const mixer<std::uint64_t, S1, S2, S3, Rounds> & h_, const std::uint64_t * x_, const std::uint64_t * y_, const std::size_t n_, std::uint64_t * bins_ ) noexcept {
+
+		std::size_t i = 0;
+
+#if defined ( __AVX512DQ__ ) and defined ( __AVX512BW__ )
+
+		const detail::mixer_epi64x8<S1, S2, S3, Rounds> h ( h_ );
+
+		alignas ( 64 ) std::uint64_t p [ 8 ];
+
+		for ( ; i + 8 <= n_; i += 8 ) {
+
+			_mm512_store_si512 ( p, detail::popcnt_epi64 ( _mm512_xor_si512 ( h ( _mm512_loadu_si512 ( x_ + i ) ), h ( _mm512_loadu_si512 ( y_ + i ) ) ) ) );
+
+			for ( std::uint32_t j = 0; j < 8; ++j ) {
+
+				++bins_ [ p [ j ] ];
+			}
+		}
+
+#elif defined ( __AVX2__ )
+
+		const detail::mixer_epi64<S1, S2, S3, Rounds> h ( h_ );
+
+		alignas ( 32 ) std::uint64_t p [ 4 ];
+
+		for ( ; i + 4 <= n_; i += 4 ) {
+
+			_mm256_store_si256 ( ( __m256i * ) p, detail::popcnt_epi64 ( _mm256_xor_si256 ( h ( _mm256_loadu_si256 ( ( const __m256i * ) ( x_ + i ) ) ), h ( _mm256_loadu_si256 ( ( const __m256i * ) ( y_ + i ) ) ) ) ) );
+
+			for ( std::uint32_t j = 0; j < 4; ++j ) {
+
+				++bins_ [ p [ j ] ];
+			}
+		}
+
+#endif
+
+		for ( ; i < n_; ++i ) {
+
+			++bins_ [ _mm_popcnt_u64 ( h_ ( x_ [ i ] ) ^ h_ ( y_ [ i ] ) ) ];
+		}
+	}
+
+
+	// Common random numbers: the mixers h_ [ 0 .. count_ ) all hash the same
+	// pairs, mixer c adds to bins_ [ c ]. The vector lanes run across the
+	// mixers, every pair is broadcast...
+
+	template<typename H>
+	void popcountHistograms ( const H * h_, const std::size_t count_, const typename H::value_type * x_, const typename H::value_type * y_, const std::size_t n_, std::uint64_t * const * bins_ ) noexcept {
+
+		using T = typename H::value_type;
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			for ( std::size_t c = 0; c < count_; ++c ) {
+
+				++bins_ [ c ] [ detail::popcnt ( T ( h_ [ c ] ( x_ [ i ] ) ^ h_ [ c ] ( y_ [ i ] ) ) ) ];
+			}
+		}
+	}
+
+	template<std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+	void popcountHistograms ( const mixer<std::uint64_t, S1, S2, S3, Rounds> * h_, const std::size_t count_, const std::uint64_t * x_, const std::uint64_t * y_, const std::size_t n_, std::uint64_t * const * bins_ ) noexcept {
+
+		std::size_t c = 0;
+
+#if defined ( __AVX512DQ__ ) and defined ( __AVX512BW__ )
+
+		alignas ( 64 ) std::uint64_t p [ 8 ];
+
+		for ( ; c + 8 <= count_; c += 8 ) {
+
+			const detail::mixer_epi64x8<S1, S2, S3, Rounds> h ( h_ + c );
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				_mm512_store_si512 ( p, detail::popcnt_epi64 ( _mm512_xor_si512 ( h ( _mm512_set1_epi64 ( std::int64_t ( x_ [ i ] ) ) ), h ( _mm512_set1_epi64 ( std::int64_t ( y_ [ i ] ) ) ) ) ) );
+
+				for ( std::uint32_t j = 0; j < 8; ++j ) {
+
+					++bins_ [ c + j ] [ p [ j ] ];
+				}
+			}
+		}
+
+#endif
+
+#ifdef __AVX2__
+
+		alignas ( 32 ) std::uint64_t q [ 4 ];
+
+		for ( ; c + 4 <= count_; c += 4 ) {
+
+			const detail::mixer_epi64<S1, S2, S3, Rounds> h ( h_ + c );
+
+			for ( std::size_t i = 0; i < n_; ++i ) {
+
+				_mm256_store_si256 ( ( __m256i * ) q, detail::popcnt_epi64 ( _mm256_xor_si256 ( h ( _mm256_set1_epi64x ( std::int64_t ( x_ [ i ] ) ) ), h ( _mm256_set1_epi64x ( std::int64_t ( y_ [ i ] ) ) ) ) ) );
+
+				for ( std::uint32_t j = 0; j < 4; ++j ) {
+
+					++bins_ [ c + j ] [ q [ j ] ];
+				}
+			}
+		}
+
+#endif
+
+		for ( ; c < count_; ++c ) {
+
+			popcountHistogram ( h_ [ c ], x_, y_, n_, bins_ [ c ] );
+		}
+	}
+
+
+	template<typename H>
+	void hashBatch ( const H & h_, const typename H::value_type * x_, typename H::value_type * y_, const std::size_t n_ ) noexcept {
+
+		for ( std::size_t i = 0; i < n_; ++i ) {
+
+			y_ [ i ] = h_ ( x_ [ i ] );
+		}
+	}
+
+	template<std::uint32_t S1, std::uint32_t S2, std::uint32_t S3, std::uint32_t Rounds>
+	void hashBatch ( const mixer<std::uint64_t, S1, S2, S3, Rounds> & h_, const std::uint64_t * x_, std::uint64_t * y_, const std::size_t n_ ) noexcept {
+
+		std::size_t i = 0;
+
+#if defined ( __AVX512DQ__ ) and defined ( __AVX512BW__ )
+
+		const detail::mixer_epi64x8<S1, S2, S3, Rounds> h ( h_ );
+
+		for ( ; i + 8 <= n_; i += 8 ) {
+
+			_mm512_storeu_si512 ( y_ + i, h ( _mm512_loadu_si512 ( x_ + i ) ) );
+		}
+
+		// The tail, masked, no scalar loop...
+
+		if ( i < n_ ) {
+
+			const __mmask8 tail = __mmask8 ( ( 1u << ( n_ - i ) ) - 1 );
+
+			_mm512_mask_storeu_epi64 ( y_ + i, tail, h ( _mm512_maskz_loadu_epi64 ( tail, x_ + i ) ) );
+		}
+
+#else
+
+#ifdef __AVX2__
+
+		const detail::mixer_epi64<S1, S2, S3, Rounds> h ( h_ );
+
+		for ( ; i + 4 <= n_; i += 4 ) {
+
+			_mm256_storeu_si256 ( ( __m256i * ) ( y_ + i ), h ( _mm256_loadu_si256 ( ( const __m256i * ) ( x_ + i ) ) ) );
+		}
+
+#endif
+
+		for ( ; i < n_; ++i ) {
+
+			y_ [ i ] = h_ ( x_ [ i ] );
+		}
+
+#endif
+	}
+};
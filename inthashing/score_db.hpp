@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+// Every multiplier ever scored, across runs. The file is a header and then
+// fixed size records, appended to only; a candidate that's scored further
+// is appended again and the last record of a key wins. On open, the file is
+// mapped and indexed in memory. A record torn by a crash (a partial tail)
+// is cut off. Only histogram scores (see popcount_histogram) are kept, as
+// they can be extended exactly...
+
+template<typename T>
+struct score_db_record {
+
+	T value, value2, inverse, inverse2; // the multipliers of the two rounds and their inverses
+	std::uint32_t variant, mix; // the mixer_family variant, the key distributions scored on (bit set)
+	std::uint64_t evaluations;
+	std::uint64_t histogram [ sizeof ( T ) * 8 + 1 ]; // popcount_histogram bins
+};
+
+struct score_db_header {
+
+	char magic [ 8 ];
+	std::uint32_t version, width;
+
+	static constexpr char signature [ 8 ] { 'I', 'H', 'S', 'C', 'D', 'B', '\0', '\0' };
+	static constexpr std::uint32_t current_version = 1;
+};
+
+
+template<typename T>
+class score_db {
+
+	struct key {
+
+		T value, value2;
+		std::uint32_t variant, mix;
+
+		bool operator == ( const key & rhs_ ) const noexcept {
+
+			return value == rhs_.value and value2 == rhs_.value2 and variant == rhs_.variant and mix == rhs_.mix;
+		}
+	};
+
+	struct key_hash {
+
+		std::size_t operator ( ) ( const key & k_ ) const noexcept {
+
+			std::uint64_t h = std::uint64_t ( k_.value ) ^ ( std::uint64_t ( k_.value2 ) * 0x9E3779B97F4A7C15 ) ^ ( ( std::uint64_t ( k_.variant ) << 32 | k_.mix ) * 0xC2B2AE3D27D4EB4F );
+
+			h = ( ( h >> 32 ) ^ h ) * 0x0CF3FD1B9997F637;
+
+			return std::size_t ( ( h >> 32 ) ^ h );
+		}
+	};
+
+	std::string m_path;
+	std::ofstream m_file;
+
+	std::unordered_map<key, score_db_record<T>, key_hash> m_index;
+
+	static key makeKey ( const score_db_record<T> & r_ ) noexcept {
+
+		return { r_.value, r_.value2, r_.variant, r_.mix };
+	}
+
+public:
+
+	// Opens (or creates) the database at path_, false if it's not a score
+	// database for this width...
+
+	bool open ( const std::string & path_ ) {
+
+		m_path = path_;
+		m_index.clear ( );
+
+		std::error_code error;
+
+		if ( std::filesystem::exists ( path_, error ) and std::filesystem::file_size ( path_, error ) ) {
+
+			std::uintmax_t size = std::filesystem::file_size ( path_, error );
+
+			if ( size < sizeof ( score_db_header ) ) {
+
+				return false;
+			}
+
+			try {
+
+				const boost::interprocess::file_mapping file ( path_.c_str ( ), boost::interprocess::read_only );
+				const boost::interprocess::mapped_region region ( file, boost::interprocess::read_only );
+
+				const char * base = ( const char * ) region.get_address ( );
+
+				score_db_header header;
+
+				std::memcpy ( & header, base, sizeof ( header ) );
+
+				if ( std::memcmp ( header.magic, score_db_header::signature, sizeof ( header.magic ) ) or header.version != score_db_header::current_version or header.width != sizeof ( T ) * 8 ) {
+
+					return false;
+				}
+
+				const std::size_t records = ( region.get_size ( ) - sizeof ( header ) ) / sizeof ( score_db_record<T> );
+
+				m_index.reserve ( records );
+
+				for ( std::size_t i = 0; i < records; ++i ) {
+
+					score_db_record<T> r;
+
+					std::memcpy ( & r, base + sizeof ( header ) + i * sizeof ( score_db_record<T> ), sizeof ( r ) );
+
+					m_index [ makeKey ( r ) ] = r;
+				}
+
+				size = sizeof ( header ) + records * sizeof ( score_db_record<T> );
+			}
+
+			catch ( const boost::interprocess::interprocess_exception & ) {
+
+				return false;
+			}
+
+			std::filesystem::resize_file ( path_, size, error ); // a torn last record...
+
+			m_file.open ( path_, std::ios::binary | std::ios::app );
+		}
+
+		else {
+
+			score_db_header header;
+
+			std::memcpy ( header.magic, score_db_header::signature, sizeof ( header.magic ) );
+			header.version = score_db_header::current_version;
+			header.width = sizeof ( T ) * 8;
+
+			m_file.open ( path_, std::ios::binary | std::ios::trunc );
+			m_file.write ( ( const char * ) & header, sizeof ( header ) );
+		}
+
+		return bool ( m_file );
+	}
+
+	bool is_open ( ) const noexcept {
+
+		return m_file.is_open ( );
+	}
+
+	std::size_t size ( ) const noexcept {
+
+		return m_index.size ( );
+	}
+
+	const score_db_record<T> * find ( const T value_, const T value2_, const std::uint32_t variant_, const std::uint32_t mix_ ) const {
+
+		const auto it = m_index.find ( { value_, value2_, variant_, mix_ } );
+
+		return it == std::end ( m_index ) ? nullptr : & it->second;
+	}
+
+	// Appends r_, unless the database already knows the key with at least
+	// as many evaluations. Returns true if it was appended...
+
+	bool store ( const score_db_record<T> & r_ ) {
+
+		if ( not r_.evaluations ) {
+
+			return false;
+		}
+
+		score_db_record<T> & r = m_index [ makeKey ( r_ ) ];
+
+		if ( r.evaluations >= r_.evaluations ) {
+
+			return false;
+		}
+
+		r = r_;
+
+		m_file.write ( ( const char * ) & r_, sizeof ( r_ ) );
+
+		return true;
+	}
+
+	void flush ( ) {
+
+		m_file.flush ( );
+	}
+
+	// For the queries, the latest record of every key...
+
+	typename std::unordered_map<key, score_db_record<T>, key_hash>::const_iterator begin ( ) const noexcept {
+
+		return std::begin ( m_index );
+	}
+
+	typename std::unordered_map<key, score_db_record<T>, key_hash>::const_iterator end ( ) const noexcept {
+
+		return std::end ( m_index );
+	}
+};
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+
+// Live counters of a running search, in a shared memory page that a viewer
+// maps read only, while the search runs on. Every thread adds to its own
+// cache line of the page, relaxed, so the writers never wait on each other
+// or on a reader. The history of the best score has a single writer, each
+// entry is guarded by its own sequence number (a seqlock), a reader that
+// catches an entry while it is being written skips it.
+//
+// Building with INTHASHING_TELEMETRY 0 leaves empty inline functions, that
+// compile to nothing...
+
+#ifndef INTHASHING_TELEMETRY
+#define INTHASHING_TELEMETRY 1
+#endif
+
+enum class telemetry_phase : std::uint32_t {
+
+	scoring,		// hashing and counting
+	rng,			// drawing the keys and bit flips
+	selection,		// confidence bounds, partitions, nth_element
+	replacement,	// breeding, and building the climb neighbours
+	count
+};
+
+inline const char * telemetryPhaseName ( const telemetry_phase p_ ) noexcept {
+
+	static const char * names [ ] = { "scoring", "rng", "selection", "replacement" };
+
+	return p_ < telemetry_phase::count ? names [ std::uint32_t ( p_ ) ] : "unknown";
+}
+
+struct alignas ( 64 ) telemetry_thread {
+
+	std::atomic<std::uint64_t> evaluations;
+	std::atomic<std::uint64_t> nanoseconds [ std::uint32_t ( telemetry_phase::count ) ];
+};
+
+struct telemetry_best {
+
+	std::atomic<std::uint64_t> sequence; // the entry number + 1 when complete, 0 while being written
+	std::atomic<std::uint64_t> generation, value, score; // the bits of the double
+};
+
+struct telemetry_page {
+
+	static constexpr char signature [ 8 ] { 'I', 'H', 'T', 'E', 'L', 'E', 'M', '\0' };
+	static constexpr std::uint32_t current_version = 1, max_threads = 256, history_size = 1'024;
+
+	char magic [ 8 ];
+	std::uint32_t version, width;
+
+	std::atomic<std::uint64_t> start; // system clock, nanoseconds since the epoch
+	std::atomic<std::uint64_t> generation, history; // entries ever written
+	std::atomic<std::uint32_t> threads, running;
+
+	telemetry_best best [ history_size ]; // a ring
+	telemetry_thread thread [ max_threads ];
+};
+
+static_assert ( std::atomic<std::uint64_t>::is_always_lock_free, "telemetry: the page needs address free atomics" );
+
+
+// The writing side, the search owns the segment and removes it when done...
+
+class telemetry {
+
+	std::string m_name;
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+	telemetry_page * m_page = nullptr;
+
+	std::atomic<std::uint32_t> m_threads { 0 };
+
+	telemetry_thread & slot ( ) noexcept {
+
+		thread_local const std::uint32_t index = [ this ] ( ) {
+
+			const std::uint32_t i = m_threads.fetch_add ( 1, std::memory_order_relaxed );
+
+			m_page->threads.fetch_add ( i < telemetry_page::max_threads, std::memory_order_relaxed );
+
+			return i;
+		} ( );
+
+		return m_page->thread [ index % telemetry_page::max_threads ];
+	}
+
+public:
+
+	telemetry ( ) = default;
+
+	telemetry ( const telemetry & ) = delete;
+	telemetry & operator = ( const telemetry & ) = delete;
+
+	~telemetry ( ) {
+
+		close ( );
+	}
+
+	// Creates (or takes over) the segment name_, false if that fails, the
+	// search then runs without...
+
+	bool open ( const std::string & name_, const std::uint32_t width_ ) {
+
+		if ( not INTHASHING_TELEMETRY ) {
+
+			return false;
+		}
+
+		close ( );
+
+		try {
+
+			boost::interprocess::shared_memory_object::remove ( name_.c_str ( ) );
+
+			boost::interprocess::shared_memory_object segment ( boost::interprocess::create_only, name_.c_str ( ), boost::interprocess::read_write );
+
+			segment.truncate ( sizeof ( telemetry_page ) );
+
+			m_region = std::make_unique<boost::interprocess::mapped_region> ( segment, boost::interprocess::read_write );
+		}
+
+		catch ( const boost::interprocess::interprocess_exception & ) {
+
+			m_region.reset ( );
+
+			return false;
+		}
+
+		m_name = name_;
+		m_page = new ( m_region->get_address ( ) ) telemetry_page { };
+
+		std::memcpy ( m_page->magic, telemetry_page::signature, sizeof ( m_page->magic ) );
+		m_page->version = telemetry_page::current_version;
+		m_page->width = width_;
+		m_page->start.store ( std::uint64_t ( std::chrono::duration_cast<std::chrono::nanoseconds> ( std::chrono::system_clock::now ( ).time_since_epoch ( ) ).count ( ) ) );
+		m_page->running.store ( 1, std::memory_order_release );
+
+		return true;
+	}
+
+	void close ( ) {
+
+		if ( m_page ) {
+
+			m_page->running.store ( 0, std::memory_order_release );
+			m_page = nullptr;
+			m_region.reset ( );
+
+			boost::interprocess::shared_memory_object::remove ( m_name.c_str ( ) );
+		}
+	}
+
+	bool is_open ( ) const noexcept {
+
+		return m_page;
+	}
+
+	void add ( const telemetry_phase p_, const std::uint64_t nanoseconds_ ) noexcept {
+
+		if ( INTHASHING_TELEMETRY and m_page ) {
+
+			slot ( ).nanoseconds [ std::uint32_t ( p_ ) ].fetch_add ( nanoseconds_, std::memory_order_relaxed );
+		}
+	}
+
+	void evaluated ( const std::uint64_t n_ ) noexcept {
+
+		if ( INTHASHING_TELEMETRY and m_page ) {
+
+			slot ( ).evaluations.fetch_add ( n_, std::memory_order_relaxed );
+		}
+	}
+
+	// The end of a generation and its best candidate, one writer only...
+
+	void generation ( const std::uint64_t generation_, const std::uint64_t value_, const double score_ ) noexcept {
+
+		if ( not INTHASHING_TELEMETRY or not m_page ) {
+
+			return;
+		}
+
+		const std::uint64_t n = m_page->history.load ( std::memory_order_relaxed );
+		telemetry_best & b = m_page->best [ n % telemetry_page::history_size ];
+
+		std::uint64_t score;
+
+		std::memcpy ( & score, & score_, sizeof ( score ) );
+
+		b.sequence.store ( 0, std::memory_order_relaxed );
+		std::atomic_thread_fence ( std::memory_order_release );
+
+		b.generation.store ( generation_, std::memory_order_relaxed );
+		b.value.store ( value_, std::memory_order_relaxed );
+		b.score.store ( score, std::memory_order_relaxed );
+
+		b.sequence.store ( n + 1, std::memory_order_release );
+
+		m_page->history.store ( n + 1, std::memory_order_release );
+		m_page->generation.store ( generation_, std::memory_order_relaxed );
+	}
+};
+
+// The search's...
+
+inline telemetry & searchTelemetry ( ) {
+
+	static telemetry t;
+
+	return t;
+}
+
+
+// Times its scope into a phase of searchTelemetry ( ), for the coarse
+// grained work only, a clock read costs some 20 ns. Without a segment (not
+// opened, or it failed) the clock is not read at all...
+
+#if INTHASHING_TELEMETRY
+
+class telemetry_scope {
+
+	const telemetry_phase m_phase;
+	const bool m_open;
+	const std::chrono::steady_clock::time_point m_start;
+
+public:
+
+	explicit telemetry_scope ( const telemetry_phase p_ ) noexcept : m_phase ( p_ ), m_open ( searchTelemetry ( ).is_open ( ) ), m_start ( m_open ? std::chrono::steady_clock::now ( ) : std::chrono::steady_clock::time_point ( ) ) { }
+
+	~telemetry_scope ( ) {
+
+		if ( m_open ) {
+
+			searchTelemetry ( ).add ( m_phase, std::uint64_t ( std::chrono::duration_cast<std::chrono::nanoseconds> ( std::chrono::steady_clock::now ( ) - m_start ).count ( ) ) );
+		}
+	}
+};
+
+#else
+
+struct telemetry_scope {
+
+	explicit telemetry_scope ( const telemetry_phase ) noexcept { }
+};
+
+#endif
+
+
+// The reading side, maps the page read only...
+
+class telemetry_view {
+
+	std::unique_ptr<boost::interprocess::mapped_region> m_region;
+	const telemetry_page * m_page = nullptr;
+
+public:
+
+	bool open ( const std::string & name_ ) {
+
+		try {
+
+			const boost::interprocess::shared_memory_object segment ( boost::interprocess::open_only, name_.c_str ( ), boost::interprocess::read_only );
+
+			m_region = std::make_unique<boost::interprocess::mapped_region> ( segment, boost::interprocess::read_only );
+		}
+
+		catch ( const boost::interprocess::interprocess_exception & ) {
+
+			return false;
+		}
+
+		if ( m_region->get_size ( ) < sizeof ( telemetry_page ) ) {
+
+			return false;
+		}
+
+		m_page = ( const telemetry_page * ) m_region->get_address ( );
+
+		return not std::memcmp ( m_page->magic, telemetry_page::signature, sizeof ( m_page->magic ) ) and m_page->version == telemetry_page::current_version;
+	}
+
+	const telemetry_page & page ( ) const noexcept {
+
+		return *m_page;
+	}
+
+	// History entry i_ (counting from the first ever written), false if it
+	// was overwritten or is being written...
+
+	bool best ( const std::uint64_t i_, std::uint64_t & generation_, std::uint64_t & value_, double & score_ ) const noexcept {
+
+		const telemetry_best & b = m_page->best [ i_ % telemetry_page::history_size ];
+
+		if ( b.sequence.load ( std::memory_order_acquire ) != i_ + 1 ) {
+
+			return false;
+		}
+
+		generation_ = b.generation.load ( std::memory_order_relaxed );
+		value_ = b.value.load ( std::memory_order_relaxed );
+
+		const std::uint64_t score = b.score.load ( std::memory_order_relaxed );
+
+		std::atomic_thread_fence ( std::memory_order_acquire );
+
+		if ( b.sequence.load ( std::memory_order_relaxed ) != i_ + 1 ) {
+
+			return false;
+		}
+
+		std::memcpy ( & score_, & score, sizeof ( score_ ) );
+
+		return true;
+	}
+};
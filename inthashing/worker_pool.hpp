@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// A fixed set of workers, started once and parked between jobs. The calling
+// thread takes part in every job as worker 0, so a pool of size ( ) == 1 spawns
+// no threads at all...
+
+class worker_pool {
+
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_start, m_done;
+
+	const std::function<void ( std::size_t )> * m_job = nullptr;
+
+	std::size_t m_generation = 0, m_running = 0;
+	bool m_stop = false;
+
+	void work ( const std::size_t id_ ) {
+
+		std::size_t generation = 0;
+
+		while ( true ) {
+
+			const std::function<void ( std::size_t )> * job;
+
+			{
+				std::unique_lock<std::mutex> lock ( m_mutex );
+
+				m_start.wait ( lock, [ & ] ( ) { return m_stop or m_generation != generation; } );
+
+				if ( m_stop ) {
+
+					return;
+				}
+
+				generation = m_generation;
+				job = m_job;
+			}
+
+			( *job ) ( id_ );
+
+			{
+				std::lock_guard<std::mutex> lock ( m_mutex );
+
+				if ( not --m_running ) {
+
+					m_done.notify_one ( );
+				}
+			}
+		}
+	}
+
+public:
+
+	explicit worker_pool ( const std::size_t threads_ = std::thread::hardware_concurrency ( ) ) {
+
+		const std::size_t n = threads_ ? threads_ : 1;
+
+		m_threads.reserve ( n - 1 );
+
+		for ( std::size_t i = 1; i < n; ++i ) {
+
+			m_threads.emplace_back ( [ this, i ] ( ) { work ( i ); } );
+		}
+	}
+
+	worker_pool ( const worker_pool & ) = delete;
+	worker_pool & operator = ( const worker_pool & ) = delete;
+
+	~worker_pool ( ) {
+
+		{
+			std::lock_guard<std::mutex> lock ( m_mutex );
+
+			m_stop = true;
+		}
+
+		m_start.notify_all ( );
+
+		for ( auto & t : m_threads ) {
+
+			t.join ( );
+		}
+	}
+
+	std::size_t size ( ) const noexcept {
+
+		return m_threads.size ( ) + 1;
+	}
+
+	// Runs job_ ( id ) once on every worker, id in [ 0, size ( ) ), and returns
+	// when all of them have finished...
+
+	void run ( const std::function<void ( std::size_t )> & job_ ) {
+
+		{
+			std::lock_guard<std::mutex> lock ( m_mutex );
+
+			m_job = & job_;
+			m_running = m_threads.size ( );
+			++m_generation;
+		}
+
+		m_start.notify_all ( );
+
+		job_ ( 0 );
+
+		std::unique_lock<std::mutex> lock ( m_mutex );
+
+		m_done.wait ( lock, [ & ] ( ) { return not m_running; } );
+	}
+
+	// Calls f_ ( i ) for every i in [ 0, n_ ), handing out grain_ sized chunks
+	// from a shared counter, so uneven work still balances...
+
+	template<typename F>
+	void parallel_for ( const std::size_t n_, F && f_, const std::size_t grain_ = 16 ) {
+
+		std::atomic<std::size_t> next ( 0 );
+
+		run ( [ & ] ( std::size_t ) {
+
+			for ( std::size_t b = next.fetch_add ( grain_ ); b < n_; b = next.fetch_add ( grain_ ) ) {
+
+				const std::size_t e = b + grain_ < n_ ? b + grain_ : n_;
+
+				for ( std::size_t i = b; i < e; ++i ) {
+
+					f_ ( i );
+				}
+			}
+		} );
+	}
+};
+
+
+// The number of workers workers ( ) starts with, to be set before its
+// first call...
+
+inline std::size_t g_worker_threads = std::thread::hardware_concurrency ( );
+
+inline worker_pool & workers ( ) {
+
+	static worker_pool pool ( std::max<std::size_t> ( 1, g_worker_threads ) );
+
+	return pool;
+}